@@ -0,0 +1,186 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtablehash.c                                                */
+/* Author: Ndongo Njie                                                */
+/* This file, benchsymtablehash.c, times putting, getting and         */
+/* removing many bindings in a hash table symbol table.               */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+enum {MAX_KEY_LENGTH = 16};
+
+/* The value bound to every key */
+static int iValue;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the CPU time in seconds since iStart. */
+
+static double secondsSince(clock_t iStart)
+{
+   return ((double)(clock() - iStart)) / CLOCKS_PER_SEC;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put the iKeyCount keys of acKeys, MAX_KEY_LENGTH characters apart,
+   into the empty oSymTable, get each of them, then remove each of
+   them, and print the time each pass takes under the name pcName.
+   Free oSymTable. Return the number of calls that did not do what was
+   expected. */
+
+static long runTrial(SymTable_T oSymTable, const char *pcName,
+   const char acKeys[], int iKeyCount)
+{
+   clock_t iStart;
+   double dPut;
+   double dGet;
+   double dRemove;
+   long lFailures = 0;
+   int i;
+
+   iStart = clock();
+   for (i = 0; i < iKeyCount; i++)
+      if (! SymTable_put(oSymTable, &acKeys[i * MAX_KEY_LENGTH], &iValue))
+         lFailures++;
+   dPut = secondsSince(iStart);
+
+   iStart = clock();
+   for (i = 0; i < iKeyCount; i++)
+      if (SymTable_get(oSymTable, &acKeys[i * MAX_KEY_LENGTH]) != &iValue)
+         lFailures++;
+   dGet = secondsSince(iStart);
+
+   iStart = clock();
+   for (i = 0; i < iKeyCount; i++)
+      if (SymTable_remove(oSymTable, &acKeys[i * MAX_KEY_LENGTH])
+          != &iValue)
+         lFailures++;
+   dRemove = secondsSince(iStart);
+
+   printf("%-10s put %8.3f  get %8.3f  remove %8.3f seconds"
+      "  (%ld failures)\n", pcName, dPut, dGet, dRemove, lFailures);
+
+   SymTable_free(oSymTable);
+   return lFailures;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put the iKeyCount keys of acKeys, MAX_KEY_LENGTH characters apart,
+   into a table made by SymTable_new, remove them from the back until
+   the table first shrinks, then time rounds of putting and removing a
+   few of the removed keys, which a table that shrank too far would
+   answer by growing and shrinking again. Print the time under the name
+   "churn". Return the number of calls that did not do what was
+   expected. */
+
+static long runChurn(const char acKeys[], int iKeyCount)
+{
+   enum {BATCH_SIZE = 8};
+   enum {ROUND_COUNT = 100000};
+
+   SymTable_T oSymTable;
+   clock_t iStart;
+   double dChurn;
+   size_t uBuckets;
+   long lFailures = 0;
+   int iBindings;
+   int iBatch;
+   int iRound;
+   int i;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      return 1;
+
+   for (i = 0; i < iKeyCount; i++)
+      if (! SymTable_put(oSymTable, &acKeys[i * MAX_KEY_LENGTH], &iValue))
+         lFailures++;
+   uBuckets = SymTable_getBucketCount(oSymTable);
+   for (iBindings = iKeyCount; iBindings > 0 &&
+        SymTable_getBucketCount(oSymTable) == uBuckets; iBindings--)
+      if (SymTable_remove(oSymTable,
+          &acKeys[(iBindings - 1) * MAX_KEY_LENGTH]) != &iValue)
+         lFailures++;
+
+   iBatch = iKeyCount - iBindings;
+   if (iBatch > BATCH_SIZE)
+      iBatch = BATCH_SIZE;
+
+   iStart = clock();
+   for (iRound = 0; iRound < ROUND_COUNT; iRound++)
+   {
+      for (i = iBindings; i < iBindings + iBatch; i++)
+         if (! SymTable_put(oSymTable, &acKeys[i * MAX_KEY_LENGTH],
+             &iValue))
+            lFailures++;
+      for (i = iBindings; i < iBindings + iBatch; i++)
+         if (SymTable_remove(oSymTable, &acKeys[i * MAX_KEY_LENGTH])
+             != &iValue)
+            lFailures++;
+   }
+   dChurn = secondsSince(iStart);
+
+   printf("%-10s %d rounds of %d at %d bindings, %lu buckets %8.3f "
+      "seconds  (%ld failures)\n", "churn", ROUND_COUNT, iBatch,
+      iBindings, (unsigned long)SymTable_getBucketCount(oSymTable),
+      dChurn, lFailures);
+
+   SymTable_free(oSymTable);
+   return lFailures;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Time putting, getting and removing argv[1] bindings in a hash
+   table, first in one made by SymTable_new and then in one sized for
+   them by SymTable_newWithCapacity, and then time bindings coming and
+   going in a table that has just shrunk. Return 0 if every call did
+   what was expected, and EXIT_FAILURE otherwise. */
+
+int main(int argc, char *argv[])
+{
+   SymTable_T oSymTable;
+   char *pcKeys;
+   int iKeyCount;
+   int iStatus = 0;
+   int i;
+
+   if (argc != 2 || sscanf(argv[1], "%d", &iKeyCount) != 1 ||
+       iKeyCount < 1)
+   {
+      fprintf(stderr, "Usage: %s keycount\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   /* The keys are made up front, so that only the table is timed */
+   pcKeys = (char*)malloc((size_t)iKeyCount * MAX_KEY_LENGTH);
+   if (pcKeys == NULL)
+   {
+      fprintf(stderr, "%s: insufficient memory\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+   for (i = 0; i < iKeyCount; i++)
+      sprintf(&pcKeys[i * MAX_KEY_LENGTH], "%d", i);
+
+   printf("%d keys\n", iKeyCount);
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL ||
+       runTrial(oSymTable, "plain", pcKeys, iKeyCount) != 0)
+      iStatus = EXIT_FAILURE;
+   oSymTable = SymTable_newWithCapacity((size_t)iKeyCount);
+   if (oSymTable == NULL ||
+       runTrial(oSymTable, "pre-sized", pcKeys, iKeyCount) != 0)
+      iStatus = EXIT_FAILURE;
+   if (runChurn(pcKeys, iKeyCount) != 0)
+      iStatus = EXIT_FAILURE;
+
+   free(pcKeys);
+   return iStatus;
+}
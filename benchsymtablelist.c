@@ -0,0 +1,175 @@
+/*--------------------------------------------------------------------*/
+/* benchsymtablelist.c                                                */
+/* Author: Ndongo Njie                                                */
+/* This file, benchsymtablelist.c, times lookups of keys drawn from   */
+/* a Zipf distribution in a plain linked list symbol table and in a   */
+/* move-to-front one.                                                 */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+/*--------------------------------------------------------------------*/
+
+enum {MAX_KEY_LENGTH = 32};
+
+/* The value bound to every key */
+static int iValue;
+
+/*--------------------------------------------------------------------*/
+
+/* Advance the xorshift generator *pulState and return its next
+   value. */
+
+static unsigned long nextRandom(unsigned long *pulState)
+{
+   unsigned long ulX = *pulState;
+   ulX ^= ulX << 13;
+   ulX ^= ulX >> 7;
+   ulX ^= ulX << 17;
+   *pulState = ulX;
+   return ulX;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Fill aiKeys with lLookups key numbers drawn from a Zipf distribution
+   with exponent dSkew over iKeyCount keys: key i (counting from 0) is
+   drawn with probability proportional to 1 / (i + 1)^dSkew. Return 1
+   (TRUE), or 0 (FALSE) if insufficient memory is available. */
+
+static int drawKeys(int aiKeys[], long lLookups, int iKeyCount,
+   double dSkew)
+{
+   double *pdCumulative;
+   double dTotal = 0.0;
+   double dTarget;
+   unsigned long ulState = 88172645463325252UL;
+   long l;
+   int i;
+   int iLow;
+   int iHigh;
+
+   pdCumulative = (double*)malloc((size_t)iKeyCount * sizeof(double));
+   if (pdCumulative == NULL)
+      return 0;
+
+   for (i = 0; i < iKeyCount; i++)
+   {
+      dTotal += 1.0 / pow((double)(i + 1), dSkew);
+      pdCumulative[i] = dTotal;
+   }
+
+   for (l = 0; l < lLookups; l++)
+   {
+      dTarget = (double)(nextRandom(&ulState) >> 11) /
+         9007199254740992.0 * dTotal;
+      iLow = 0;
+      iHigh = iKeyCount - 1;
+      while (iLow < iHigh)
+      {
+         i = iLow + (iHigh - iLow) / 2;
+         if (pdCumulative[i] < dTarget)
+            iLow = i + 1;
+         else
+            iHigh = i;
+      }
+      aiKeys[l] = iLow;
+   }
+
+   free(pdCumulative);
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put iKeyCount keys into a new table made by (*pfNew)(), the most
+   popular key first so that it starts at the back of the list, then
+   look up the lLookups keys numbered in aiKeys, and print the time
+   taken under the name pcName. Return the number of lookups that did
+   not find the expected value, or -1 if the table could not be made. */
+
+static long runTrial(SymTable_T (*pfNew)(void), const char *pcName,
+   const int aiKeys[], long lLookups, int iKeyCount)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   clock_t iStart;
+   clock_t iEnd;
+   long lFailures = 0;
+   long l;
+   int i;
+
+   oSymTable = (*pfNew)();
+   if (oSymTable == NULL)
+      return -1;
+
+   for (i = 0; i < iKeyCount; i++)
+   {
+      sprintf(acKey, "key%d", i);
+      if (! SymTable_put(oSymTable, acKey, &iValue))
+         lFailures++;
+   }
+
+   iStart = clock();
+   for (l = 0; l < lLookups; l++)
+   {
+      sprintf(acKey, "key%d", aiKeys[l]);
+      if (SymTable_get(oSymTable, acKey) != &iValue)
+         lFailures++;
+   }
+   iEnd = clock();
+
+   printf("%-14s %8.3f seconds  (%ld failures)\n", pcName,
+      ((double)(iEnd - iStart)) / CLOCKS_PER_SEC, lFailures);
+
+   SymTable_free(oSymTable);
+   return lFailures;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Time argv[2] lookups of Zipf-distributed keys, with exponent argv[3]
+   (1.0 if omitted), in tables of argv[1] keys, first in a plain table
+   and then in a move-to-front one. Return 0 if every lookup succeeded,
+   and EXIT_FAILURE otherwise. */
+
+int main(int argc, char *argv[])
+{
+   int *piKeys;
+   int iKeyCount;
+   long lLookups;
+   double dSkew = 1.0;
+   int iStatus = 0;
+
+   if ((argc != 3 && argc != 4) ||
+       sscanf(argv[1], "%d", &iKeyCount) != 1 ||
+       sscanf(argv[2], "%ld", &lLookups) != 1 ||
+       (argc == 4 && sscanf(argv[3], "%lf", &dSkew) != 1) ||
+       iKeyCount < 1 || lLookups < 0 || dSkew < 0.0)
+   {
+      fprintf(stderr, "Usage: %s keycount lookups [skew]\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   piKeys = (int*)malloc((size_t)(lLookups + 1) * sizeof(int));
+   if (piKeys == NULL || ! drawKeys(piKeys, lLookups, iKeyCount, dSkew))
+   {
+      fprintf(stderr, "%s: insufficient memory\n", argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   printf("%d keys, %ld lookups, Zipf skew %.2f\n", iKeyCount, lLookups,
+      dSkew);
+   if (runTrial(SymTable_new, "plain", piKeys, lLookups, iKeyCount) != 0)
+      iStatus = EXIT_FAILURE;
+   if (runTrial(SymTable_newMoveToFront, "move-to-front", piKeys,
+                lLookups, iKeyCount) != 0)
+      iStatus = EXIT_FAILURE;
+
+   free(piKeys);
+   return iStatus;
+}
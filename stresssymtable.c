@@ -0,0 +1,253 @@
+/*--------------------------------------------------------------------*/
+/* stresssymtable.c                                                   */
+/* Author: Ndongo Njie                                                */
+/* This file, stresssymtable.c, hammers the concurrent symbol tables  */
+/* with threads doing mixed puts, gets and removes, checks the        */
+/* results, and reports throughput as the thread count rises.         */
+/*--------------------------------------------------------------------*/
+
+/* clock_gettime is a POSIX.1-2001 feature */
+#define _POSIX_C_SOURCE 200809L
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of bindings put before the threads start. They are never
+   removed, so every get of one of them must succeed. */
+enum {SHARED_KEY_COUNT = 100000};
+
+/* The number of keys each thread puts and removes. Only the owning
+   thread touches them, so it knows which of them are present. */
+enum {OWN_KEY_COUNT = 4096};
+
+enum {MAX_KEY_LENGTH = 32};
+
+/* The value bound to shared key i is &acSharedValues[i] */
+static char acSharedValues[SHARED_KEY_COUNT];
+
+/* The value bound to every thread's own keys */
+static char cOwnValue;
+
+/*--------------------------------------------------------------------*/
+
+/* A Worker holds one thread's arguments and results. */
+
+struct Worker
+{
+   /* The table under test */
+   SymTable_T oSymTable;
+
+   /* The thread's number, which names its own keys */
+   int iId;
+
+   /* The number of operations to do */
+   long lOps;
+
+   /* The percentage of operations that are gets */
+   int iReadPercent;
+
+   /* The number of results that contradicted the thread's model */
+   long lFailures;
+
+   /* 1 for each own key that the thread has put and not removed */
+   char acPresent[OWN_KEY_COUNT];
+
+   /* The thread's pthread */
+   pthread_t sThread;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Advance the xorshift generator *pulState and return its next
+   value. */
+
+static unsigned long nextRandom(unsigned long *pulState)
+{
+   unsigned long ulX = *pulState;
+   ulX ^= ulX << 13;
+   ulX ^= ulX >> 7;
+   ulX ^= ulX << 17;
+   *pulState = ulX;
+   return ulX;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run the operations of the Worker at pvWorker: gets of shared keys,
+   and an even mix of puts and removes of the worker's own keys. Return
+   NULL. */
+
+static void *runWorker(void *pvWorker)
+{
+   struct Worker *psWorker = (struct Worker*)pvWorker;
+   char acKey[MAX_KEY_LENGTH];
+   unsigned long ulState;
+   unsigned long ulRandom;
+   long lOp;
+   int iKey;
+   void *pvValue;
+
+   ulState = 88172645463325252UL + (unsigned long)psWorker->iId * 7919;
+   for (lOp = 0; lOp < psWorker->lOps; lOp++)
+   {
+      ulRandom = nextRandom(&ulState);
+      if ((int)(ulRandom % 100) < psWorker->iReadPercent)
+      {
+         iKey = (int)((ulRandom >> 8) % SHARED_KEY_COUNT);
+         sprintf(acKey, "shared%d", iKey);
+         pvValue = SymTable_get(psWorker->oSymTable, acKey);
+         if (pvValue != &acSharedValues[iKey])
+            psWorker->lFailures++;
+         continue;
+      }
+
+      iKey = (int)((ulRandom >> 8) % OWN_KEY_COUNT);
+      sprintf(acKey, "t%d.%d", psWorker->iId, iKey);
+      if ((ulRandom & 1) == 0)
+      {
+         if (SymTable_put(psWorker->oSymTable, acKey, &cOwnValue) ==
+             psWorker->acPresent[iKey])
+            psWorker->lFailures++;
+         psWorker->acPresent[iKey] = 1;
+      }
+      else
+      {
+         pvValue = SymTable_remove(psWorker->oSymTable, acKey);
+         if ((pvValue != NULL) != psWorker->acPresent[iKey])
+            psWorker->lFailures++;
+         psWorker->acPresent[iKey] = 0;
+      }
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run iThreads threads doing lOps operations each, iReadPercent% of
+   them gets, against a new table made by (*pfNew)(), print the
+   throughput under the name pcName, and return the number of failures
+   seen, or -1 if the run could not be set up. */
+
+static long runTrial(SymTable_T (*pfNew)(void), const char *pcName,
+   int iThreads, long lOps, int iReadPercent)
+{
+   SymTable_T oSymTable;
+   struct Worker *psWorkers;
+   struct timespec sStart;
+   struct timespec sEnd;
+   char acKey[MAX_KEY_LENGTH];
+   size_t uExpectedLength = SHARED_KEY_COUNT;
+   double dSeconds;
+   long lFailures = 0;
+   int i;
+   int iKey;
+
+   oSymTable = (*pfNew)();
+   psWorkers = (struct Worker*)calloc((size_t)iThreads,
+      sizeof(struct Worker));
+   if (oSymTable == NULL || psWorkers == NULL)
+   {
+      if (oSymTable != NULL)
+         SymTable_free(oSymTable);
+      free(psWorkers);
+      return -1;
+   }
+
+   for (iKey = 0; iKey < SHARED_KEY_COUNT; iKey++)
+   {
+      sprintf(acKey, "shared%d", iKey);
+      SymTable_put(oSymTable, acKey, &acSharedValues[iKey]);
+   }
+
+   clock_gettime(CLOCK_MONOTONIC, &sStart);
+   for (i = 0; i < iThreads; i++)
+   {
+      psWorkers[i].oSymTable = oSymTable;
+      psWorkers[i].iId = i;
+      psWorkers[i].lOps = lOps;
+      psWorkers[i].iReadPercent = iReadPercent;
+      if (pthread_create(&psWorkers[i].sThread, NULL, runWorker,
+                         &psWorkers[i]) != 0)
+      {
+         /* The started threads end on their own after lOps
+            operations, so wait for them before freeing what they
+            use */
+         while (i > 0)
+            pthread_join(psWorkers[--i].sThread, NULL);
+         SymTable_free(oSymTable);
+         free(psWorkers);
+         return -1;
+      }
+   }
+   for (i = 0; i < iThreads; i++)
+      pthread_join(psWorkers[i].sThread, NULL);
+   clock_gettime(CLOCK_MONOTONIC, &sEnd);
+
+   for (i = 0; i < iThreads; i++)
+   {
+      lFailures += psWorkers[i].lFailures;
+      for (iKey = 0; iKey < OWN_KEY_COUNT; iKey++)
+         uExpectedLength += (size_t)psWorkers[i].acPresent[iKey];
+   }
+   if (SymTable_getLength(oSymTable) != uExpectedLength)
+      lFailures++;
+
+   dSeconds = (double)(sEnd.tv_sec - sStart.tv_sec) +
+      (double)(sEnd.tv_nsec - sStart.tv_nsec) / 1e9;
+   printf("%3d threads, %-10s %8.2f Mops/s  (%ld failures)\n",
+      iThreads, pcName, (double)lOps * iThreads / dSeconds / 1e6,
+      lFailures);
+
+   SymTable_free(oSymTable);
+   free(psWorkers);
+   return lFailures;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run trials of both concurrent tables with 1, 2, 4, ... up to argv[1]
+   threads, each doing argv[2] operations of which argv[3] percent
+   (80 if omitted) are gets. Return 0 if every result was as expected,
+   and EXIT_FAILURE otherwise. */
+
+int main(int argc, char *argv[])
+{
+   int iMaxThreads;
+   int iThreads;
+   int iReadPercent = 80;
+   long lOps;
+   int iStatus = 0;
+
+   if ((argc != 3 && argc != 4) ||
+       sscanf(argv[1], "%d", &iMaxThreads) != 1 ||
+       sscanf(argv[2], "%ld", &lOps) != 1 ||
+       (argc == 4 && sscanf(argv[3], "%d", &iReadPercent) != 1) ||
+       iMaxThreads < 1 || lOps < 0 ||
+       iReadPercent < 0 || iReadPercent > 100)
+   {
+      fprintf(stderr, "Usage: %s maxthreads opsperthread [readpercent]\n",
+         argv[0]);
+      exit(EXIT_FAILURE);
+   }
+
+   for (iThreads = 1; ; iThreads *= 2)
+   {
+      if (iThreads > iMaxThreads)
+         iThreads = iMaxThreads;
+      if (runTrial(SymTable_newConcurrent, "striped", iThreads, lOps,
+                   iReadPercent) != 0)
+         iStatus = EXIT_FAILURE;
+      if (runTrial(SymTable_newReadMostly, "lock-free", iThreads, lOps,
+                   iReadPercent) != 0)
+         iStatus = EXIT_FAILURE;
+      if (iThreads == iMaxThreads)
+         break;
+   }
+   return iStatus;
+}
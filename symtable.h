@@ -23,6 +23,173 @@ SymTable_T SymTable_new(void);
 
 /*--------------------------------------------------------------------*/
 
+/* Handles the new incremental symtable function. Like SymTable_new,
+but when the table grows, the old buckets are moved into the new bucket
+array a few at a time by later calls instead of all in the call that
+triggered the growth, so no single call pays for the whole rehash.
+Return NULL if insufficient memory is available. Only the hash table
+implementation provides this function. */
+
+SymTable_T SymTable_newIncremental(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new symtable with policy function. Like SymTable_new,
+but the table grows (past the default table's sizes, up to about four 
+billion buckets) whenever it holds more than dMaxLoadFactor bindings 
+per bucket, instead of the default of 1. dMaxLoadFactor must be positive. Return NULL if insufficient memory
+is available. Only the hash table implementation provides this
+function. */
+
+SymTable_T SymTable_newWithPolicy(double dMaxLoadFactor);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new arena symtable function. Like SymTable_new, but the
+table's nodes and key copies are carved from large chunks of memory, 
+removed nodes are reused by later puts, and SymTable_free releases 
+everything by freeing only the chunks. Return NULL if insufficient 
+memory is available. Only the linked list and hash table 
+implementations provide this function. */
+
+SymTable_T SymTable_newArena(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new move-to-front symtable function. Like SymTable_new,
+but every binding found by a lookup (a get, contains, replace or 
+getOrInsert, in any of their forms) is moved to the front of the list,
+so that under skewed access the keys in use are found after a few 
+comparisons. Because lookups reorder the 
+table, it must not be searched between SymTable_iterBegin and 
+SymTable_iterEnd. Return NULL if insufficient memory is available. 
+Only the linked list implementation provides this function. */
+
+SymTable_T SymTable_newMoveToFront(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new symtable with capacity function. Like SymTable_new,
+but the table is sized up front for uExpected bindings, so that putting
+that many bindings never has to grow it. Return NULL if insufficient 
+memory is available, or if no table could ever hold uExpected 
+bindings. Only the hash table, open addressing, Swiss and concurrent 
+implementations provide this function. */
+
+SymTable_T SymTable_newWithCapacity(size_t uExpected);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new parallel resize symtable function. Like 
+SymTable_new, but once the table is large, each resize splits the old 
+buckets among uThreads threads (the calling thread and uThreads-1 
+others) that move their nodes into the new bucket array together, so 
+that growing a table of tens of millions of bindings does not stall 
+one thread for seconds. The bindings end up in the same buckets as 
+after a one-thread resize. uThreads must be positive. Return NULL if 
+insufficient memory is available. Only the hash table implementation 
+provides this function. */
+
+SymTable_T SymTable_newParallelResize(size_t uThreads);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new concurrent symtable function. Like SymTable_new, but
+every function on the returned table except SymTable_free may be
+called by many threads at once. Each operation locks only the group of
+buckets that holds its key, and the table grows while in use.
+SymTable_getLength returns a snapshot that may be stale by the time it
+returns. The pfApply given to SymTable_map must not call functions on
+the same table. Return NULL if insufficient memory is available. Only
+the concurrent implementation provides this function, and its
+SymTable_new returns the same kind of table. */
+
+SymTable_T SymTable_newConcurrent(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new read-mostly symtable function. Like 
+SymTable_newConcurrent, but SymTable_get and SymTable_contains take no
+lock at all, so that reader threads do not contend with one another. 
+Memory given up by SymTable_remove and by growth is freed only once no
+reader can still be looking at it, and growing copies every binding, 
+so writes cost more than in a SymTable_newConcurrent table. Return NULL
+if insufficient memory is available. Only the concurrent implementation
+provides this function. */
+
+SymTable_T SymTable_newReadMostly(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the new symtable with hash function. Like SymTable_new, but
+keys are hashed with (*pfHash)(pcKey, uLength), where uLength is the 
+length of pcKey, and two keys of the same length uLength are equal if 
+(*pfEqual)(pcKey1, pcKey2, uLength) returns nonzero. pfEqual may be 
+NULL to compare bytes, and keys of different lengths are never equal. 
+SymTable_hashFast and SymTable_hashLegacy can be passed as pfHash. 
+Return NULL if insufficient memory is available. Only the hash table 
+implementation provides this function. */
+
+SymTable_T SymTable_newWithHash(
+   size_t (*pfHash)(const char *pcKey, size_t uLength),
+   int (*pfEqual)(const char *pcKey1, const char *pcKey2, size_t uLength));
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the freeze function of the symbol table. Writes every 
+binding of oSymTable to the file at pcPath as an image that 
+SymTable_openFrozen can map, replacing any file already there only 
+once the new image is complete. The image holds a copy of each key and
+of the (*pfValueSize)(pvValue) bytes at each non-NULL value pvValue, 
+and offsets rather than addresses, so it can be mapped anywhere, though
+only on a machine with the same word size and byte order. Return 1 
+(TRUE), or 0 (FALSE) if insufficient memory is available, the file 
+cannot be written, or oSymTable was made by SymTable_newWithHash with a
+pfEqual. The bindings of oSymTable are unchanged, though a resize in 
+progress is finished first. Only the hash table implementation 
+provides this function. */
+
+int SymTable_freeze(SymTable_T oSymTable, const char *pcPath,
+   size_t (*pfValueSize)(const void *pvValue));
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the open frozen function of the symbol table. Maps the image
+that SymTable_freeze wrote to pcPath read-only and returns a table 
+that answers SymTable_getLength, SymTable_contains, SymTable_containsN,
+SymTable_get, SymTable_getN and SymTable_map straight from the mapped 
+pages, which the system reads in as they are first touched and shares 
+among every process that maps the same file. The values returned point
+into the image and must not be changed. No other function but 
+SymTable_free may be called on the table. Return NULL if the file 
+cannot be mapped or does not start with such an image's header. Only 
+the header is checked here; an entry that a damaged image places 
+outside the file is skipped by the lookups and the map that reach it.
+Only the hash table implementation provides this function. */
+
+SymTable_T SymTable_openFrozen(const char *pcPath);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the fast hash function. Return a hash code for the uLength 
+characters at pcKey, computed 8 bytes at a time with every bit of the 
+result depending on every bit of the key. This is the hash a hash 
+table uses unless it was made with SymTable_newWithHash. */
+
+size_t SymTable_hashFast(const char *pcKey, size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the legacy hash function. Return the assignment 
+specification's hash code (multiply by 65599 and add each character) 
+for the uLength characters at pcKey. A table made with 
+SymTable_newWithHash(SymTable_hashLegacy, NULL) places keys in the same
+buckets as the original hash table implementation. */
+
+size_t SymTable_hashLegacy(const char *pcKey, size_t uLength);
+
+/*--------------------------------------------------------------------*/
+
 /* Handles the function that frees the symbol table. Takes oSymTable 
 as an argument and free all memory occupied by it. It does not return
 anything. */
@@ -37,6 +204,42 @@ oSymTable. */
 
 size_t SymTable_getLength(SymTable_T oSymTable);
 
+/*--------------------------------------------------------------------*/
+
+/* Handles the shrink to fit function of the symbol table. Takes 
+oSymTable as an argument and shrinks its bucket array to the smallest 
+size that holds its current bindings within its load factor, releasing
+the memory at once. Tables also shrink on their own as bindings are 
+removed; this call is for returning memory right after a bulk delete. 
+It does not return anything. Only the hash table implementation 
+provides this function. */
+
+void SymTable_shrinkToFit(SymTable_T oSymTable);
+
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the reserve function of the symbol table. Grows oSymTable at
+once, if needed, to the size that holds uExpected bindings within its 
+load factor, so that the puts that follow never have to grow it, and 
+keeps removals from shrinking it below that size until the next 
+SymTable_shrinkToFit. Return 1 (TRUE), or 0 (FALSE) and leave 
+oSymTable unchanged if insufficient memory is available or no table 
+could ever hold uExpected bindings. Only the hash table, open 
+addressing and Swiss table implementations provide this function. */
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uExpected);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the function that gets the bucket count of the symbol table.
+Takes oSymTable as an argument and return the number of buckets its 
+bindings are spread over: 1 while it is still small enough for one 
+chain, and the size of the newer array while an incremental resize is 
+partly done. Only the hash table implementation provides this 
+function. */
+
+size_t SymTable_getBucketCount(SymTable_T oSymTable);
 
 /*--------------------------------------------------------------------*/
 
@@ -50,6 +253,21 @@ int SymTable_put(SymTable_T oSymTable,
 
 /*--------------------------------------------------------------------*/
 
+/* Handles the get or insert function of the symbol table. If oSymTable
+contains a binding with key pcKey, set *piInserted to 0 (FALSE); 
+otherwise add a binding of pcKey to NULL and set *piInserted to 1 
+(TRUE). Either way return the address of the binding's value, so that 
+the caller can read or update it in place after a single lookup. The 
+address stays valid until the next call that adds or removes a binding
+of oSymTable, or frees it. Return NULL and leave oSymTable unchanged if
+insufficient memory is available. Only the linked list and hash table 
+implementations provide this function. */
+
+void **SymTable_getOrInsert(SymTable_T oSymTable, const char *pcKey,
+     int *piInserted);
+
+/*--------------------------------------------------------------------*/
+
 /* Handles the replace function of the symbol table. If oSymTable 
 contains a binding with key pcKey, then SymTable_replace must replace 
 the binding's value with pvValue and return the old value. Otherwise it 
@@ -79,6 +297,19 @@ binding exists. */
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey);
 
 
+/*--------------------------------------------------------------------*/
+
+/* Handles the get many function of the symbol table. For each i from 0
+to uCount-1, set apvValuesOut[i] to the value of the binding within 
+oSymTable whose key is apcKeys[i], or to NULL if no such binding 
+exists, and return the number of keys found. The lookups are done in 
+groups whose memory loads overlap, which is much faster than uCount 
+calls of SymTable_get when the table does not fit in the cache. Only 
+the hash table implementation provides this function. */
+
+size_t SymTable_getMany(SymTable_T oSymTable, const char *apcKeys[],
+     size_t uCount, void *apvValuesOut[]);
+
 /*--------------------------------------------------------------------*/
 
 /* Handles the remove function of the symbol table. Takes two arguments 
@@ -94,10 +325,238 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey);
 /* Handles the map function of the symbol table. Apply function *pfApply 
 to each binding in oSymTable, passing pvExtra as an extra parameter. 
 That is, the function must call (*pfApply)(pcKey, pvValue, pvExtra) for 
-each pcKey/pvValue binding in oSymTable*/
+each pcKey/pvValue binding in oSymTable. The tree and radix tree 
+implementations visit the bindings in ascending strcmp order of their 
+keys. */
 
 void SymTable_map(SymTable_T oSymTable,
         void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
         const void *pvExtra);
 
+/*--------------------------------------------------------------------*/
+
+/* Handles the range map function of the symbol table. Like 
+SymTable_map, but only the bindings whose keys sort (by strcmp) at or 
+after pcLow and before pcHigh are visited, in ascending key order. A 
+NULL pcLow or pcHigh leaves that end of the range open, so all keys 
+starting with "ab" are those from "ab" up to "ac". Subtrees outside the
+range are skipped, so the cost grows with the number of bindings in 
+the range rather than in the table. Only the tree implementation 
+provides this function. */
+
+void SymTable_mapRange(SymTable_T oSymTable,
+        const char *pcLow, const char *pcHigh,
+        void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+        const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the prefix map function of the symbol table. Like 
+SymTable_map, but only the bindings whose keys start with pcPrefix are 
+visited, in ascending key order. The search walks down pcPrefix once 
+and then visits only the subtree below it, so the cost is the length 
+of pcPrefix plus the number of bindings visited. Only the radix tree 
+implementation provides this function. */
+
+void SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+        void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+        const void *pvExtra);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the parallel map function of the symbol table. Like 
+SymTable_map, but the bindings are visited by up to uThreads threads at
+once, in no particular order, and each thread i passes apvExtra[i] as 
+the extra parameter, so that per-thread results can be accumulated 
+without locks and combined afterwards. apvExtra must hold uThreads 
+elements, and uThreads must be positive. The buckets are split into 
+ranges that idle threads steal from busy ones, so that a few long 
+chains do not leave one thread working alone. pfApply must not change
+oSymTable. Return once every binding has been visited. Only the hash 
+table implementation provides this function. */
+
+void SymTable_mapParallel(SymTable_T oSymTable,
+        void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+        void *const apvExtra[], size_t uThreads);
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable_Iter is a cursor over the bindings of a table, meant to 
+live on the caller's stack. Its fields belong to the implementation. */
+
+typedef struct SymTableIter
+{
+   /* The table being enumerated */
+   SymTable_T oSymTable;
+
+   /* The binding that SymTable_iterNext returns next, or NULL */
+   const void *pvNode;
+
+   /* The bucket after the one that holds pvNode */
+   size_t uBucket;
+} SymTable_Iter;
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the iterator begin function of the symbol table. Set 
+*psIter to the start of oSymTable's bindings. Between this call and 
+SymTable_iterEnd, oSymTable must not gain bindings, but it may be 
+searched, values may be replaced, and the binding last returned by 
+SymTable_iterNext may be removed. While the cursor is open, removals do
+not shrink the table and lookups in a move-to-front table do not 
+reorder it, so every call must be matched by a call of 
+SymTable_iterEnd. Only the linked list and hash table implementations 
+provide this function, SymTable_iterNext and SymTable_iterEnd. */
+
+void SymTable_iterBegin(SymTable_T oSymTable, SymTable_Iter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the iterator next function of the symbol table. Store the 
+key and value of the next binding of *psIter's table in *ppcKey and 
+*ppvValue and return 1 (TRUE), or return 0 (FALSE) once every binding 
+has been returned. Each binding is returned once, in no particular 
+order. The caller may stop at any point, and then call 
+SymTable_iterEnd. */
+
+int SymTable_iterNext(SymTable_Iter *psIter, const char **ppcKey,
+     void **ppvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the iterator end function of the symbol table. Finish with 
+*psIter, which must not be used again until it is passed to 
+SymTable_iterBegin. A table that the removals left mostly empty may 
+shrink now. */
+
+void SymTable_iterEnd(SymTable_Iter *psIter);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the length-delimited put function of the symbol table. Like
+SymTable_put, but the key is the uLen characters at pcKey, which need
+not be followed by a '\0'. The binding gets its own terminated copy of
+the key. Keys are equal when they have the same length and the same
+bytes, so a key containing '\0' can only be reached through the
+length-delimited functions. Only the linked list and hash table
+implementations provide this function and the four that follow. */
+
+int SymTable_putN(SymTable_T oSymTable,
+     const char *pcKey, size_t uLen, const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the length-delimited replace function of the symbol table.
+Like SymTable_replace, but the key is the uLen characters at pcKey. */
+
+void *SymTable_replaceN(SymTable_T oSymTable,
+     const char *pcKey, size_t uLen, const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the length-delimited contain function of the symbol table.
+Like SymTable_contains, but the key is the uLen characters at pcKey. */
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the length-delimited get function of the symbol table. Like
+SymTable_get, but the key is the uLen characters at pcKey. */
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the length-delimited remove function of the symbol table.
+Like SymTable_remove, but the key is the uLen characters at pcKey. */
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen);
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTable_Key is a key together with its length and its 
+SymTable_hashFast hash code, computed once by SymTable_makeKey so that 
+looking the key up in many tables hashes it only once. It refers to 
+the caller's characters and does not copy them. */
+
+typedef struct SymTableKey
+{
+   /* The key */
+   const char *pcKey;
+
+   /* The length of pcKey */
+   size_t uLength;
+
+   /* SymTable_hashFast(pcKey, uLength) */
+   size_t uHash;
+} SymTable_Key;
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the make key function. Return the SymTable_Key for pcKey. 
+pcKey must stay unchanged for as long as the returned key is used. */
+
+SymTable_Key SymTable_makeKey(const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the prehashed put function of the symbol table. Like 
+SymTable_put, but with the key and its hash code taken from sKey. 
+Tables made with SymTable_newWithHash rehash sKey's characters with 
+their own hash function. Only the linked list and hash table 
+implementations provide this function, SymTable_getK and 
+SymTable_removeK. */
+
+int SymTable_putK(SymTable_T oSymTable, SymTable_Key sKey,
+     const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the prehashed get function of the symbol table. Like 
+SymTable_get, but with the key and its hash code taken from sKey. */
+
+void *SymTable_getK(SymTable_T oSymTable, SymTable_Key sKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the prehashed remove function of the symbol table. Like 
+SymTable_remove, but with the key and its hash code taken from sKey. */
+
+void *SymTable_removeK(SymTable_T oSymTable, SymTable_Key sKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the intern function. Takes a constant pointer to a character
+pcKey and return the process-wide canonical copy of that string, 
+creating it (with its hash code and length) the first time the string 
+is seen, or NULL if insufficient memory is available. Equal strings 
+always give the same pointer. Interned strings live until the process 
+ends. Not safe to call from several threads at once. */
+
+const char *SymTable_intern(const char *pcKey);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the put interned function of the symbol table. Like 
+SymTable_put, but pcInterned must be a string returned by 
+SymTable_intern; the binding points at it instead of copying it. */
+
+int SymTable_putInterned(SymTable_T oSymTable,
+     const char *pcInterned, const void *pvValue);
+
+/*--------------------------------------------------------------------*/
+
+/* Handles the get interned function of the symbol table. Like 
+SymTable_get, but pcInterned must be a string returned by 
+SymTable_intern. Bindings put with SymTable_putInterned are found by 
+pointer comparison, without hashing or comparing any characters. Only 
+the linked list and hash table implementations provide this function 
+and SymTable_putInterned. */
+
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned);
+
 #endif
\ No newline at end of file
@@ -0,0 +1,207 @@
+/*--------------------------------------------------------------------*/
+/* symtablearena.c                                                    */
+/* Author: Ndongo Njie                                                */
+/* This file, symtablearena.c, implements the chunk allocator used    */
+/* by the arena mode of the symbol tables.                            */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symtablearena.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Block sizes are rounded up to a multiple of this many bytes, which
+   is also the alignment of every block. */
+enum {GRANULE = 16};
+
+/* The number of free lists. Free list i holds released blocks of
+   (i + 1) * GRANULE bytes; larger blocks are not reused. */
+enum {NUM_SIZE_CLASSES = 32};
+
+/* The number of usable bytes in an ordinary chunk. Requests larger
+   than a quarter of this get a chunk of their own. */
+enum {CHUNK_SIZE = 64 * 1024};
+
+/*--------------------------------------------------------------------*/
+
+/* Each chunk starts with a SymTableArenaChunk header. The chunks of an
+   arena are linked to form a list. */
+
+struct SymTableArenaChunk
+{
+   /* The address of the next chunk. The union pads the header to a
+      multiple of GRANULE bytes so that the usable bytes that follow
+      it are aligned. */
+   union
+   {
+      struct SymTableArenaChunk *psNextChunk;
+      char acPad[GRANULE];
+   } u;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A released block holds the address of the next released block of
+   the same size. */
+
+struct SymTableArenaBlock
+{
+   /* The address of the next free block */
+   struct SymTableArenaBlock *psNextBlock;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableArena owns a list of chunks and carves blocks from the
+   most recent one. */
+
+struct SymTableArena
+{
+   /* The address of the first chunk */
+   struct SymTableArenaChunk *psFirstChunk;
+
+   /* The first unused byte of the current chunk */
+   char *pcNextByte;
+
+   /* The number of unused bytes left in the current chunk */
+   size_t uBytesLeft;
+
+   /* The released blocks, by size class */
+   struct SymTableArenaBlock *apsFreeBlocks[NUM_SIZE_CLASSES];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new chunk with uSize usable bytes linked at the front of
+   oArena's chunk list, or NULL if insufficient memory is available. */
+
+static struct SymTableArenaChunk *SymTableArena_addChunk(
+   SymTableArena_T oArena, size_t uSize)
+{
+   struct SymTableArenaChunk *psChunk;
+
+   assert(oArena != NULL);
+
+   psChunk = (struct SymTableArenaChunk*)
+      malloc(sizeof(struct SymTableArenaChunk) + uSize);
+   if (psChunk == NULL)
+      return NULL;
+
+   psChunk->u.psNextChunk = oArena->psFirstChunk;
+   oArena->psFirstChunk = psChunk;
+   return psChunk;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTableArena_T SymTableArena_new(void)
+{
+   SymTableArena_T oArena;
+   size_t u;
+
+   oArena = (SymTableArena_T)malloc(sizeof(struct SymTableArena));
+   if (oArena == NULL)
+      return NULL;
+
+   oArena->psFirstChunk = NULL;
+   oArena->pcNextByte = NULL;
+   oArena->uBytesLeft = 0;
+   for (u = 0; u < NUM_SIZE_CLASSES; u++)
+      oArena->apsFreeBlocks[u] = NULL;
+   return oArena;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTableArena_free(SymTableArena_T oArena)
+{
+   struct SymTableArenaChunk *psChunk;
+   struct SymTableArenaChunk *psNextChunk;
+
+   assert(oArena != NULL);
+
+   for (psChunk = oArena->psFirstChunk;
+        psChunk != NULL;
+        psChunk = psNextChunk)
+   {
+      psNextChunk = psChunk->u.psNextChunk;
+      free(psChunk);
+   }
+   free(oArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTableArena_alloc(SymTableArena_T oArena, size_t uSize)
+{
+   struct SymTableArenaChunk *psChunk;
+   struct SymTableArenaBlock *psBlock;
+   size_t uClass;
+   void *pvBlock;
+
+   assert(oArena != NULL);
+
+   uSize = (uSize + GRANULE - 1) / GRANULE * GRANULE;
+   if (uSize == 0)
+      uSize = GRANULE;
+
+   /* Reuse a released block of the same size if there is one */
+   uClass = uSize / GRANULE - 1;
+   if (uClass < NUM_SIZE_CLASSES && oArena->apsFreeBlocks[uClass] != NULL)
+   {
+      psBlock = oArena->apsFreeBlocks[uClass];
+      oArena->apsFreeBlocks[uClass] = psBlock->psNextBlock;
+      return psBlock;
+   }
+
+   /* Large requests get a chunk of their own, so that the current
+      chunk keeps its unused bytes */
+   if (uSize > CHUNK_SIZE / 4)
+   {
+      psChunk = SymTableArena_addChunk(oArena, uSize);
+      if (psChunk == NULL)
+         return NULL;
+      return psChunk + 1;
+   }
+
+   if (uSize > oArena->uBytesLeft)
+   {
+      psChunk = SymTableArena_addChunk(oArena, CHUNK_SIZE);
+      if (psChunk == NULL)
+         return NULL;
+      oArena->pcNextByte = (char*)(psChunk + 1);
+      oArena->uBytesLeft = CHUNK_SIZE;
+   }
+
+   pvBlock = oArena->pcNextByte;
+   oArena->pcNextByte += uSize;
+   oArena->uBytesLeft -= uSize;
+   return pvBlock;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTableArena_release(SymTableArena_T oArena, void *pvBlock,
+   size_t uSize)
+{
+   struct SymTableArenaBlock *psBlock;
+   size_t uClass;
+
+   assert(oArena != NULL);
+   assert(pvBlock != NULL);
+
+   uSize = (uSize + GRANULE - 1) / GRANULE * GRANULE;
+   if (uSize == 0)
+      uSize = GRANULE;
+
+   /* Blocks too large for a free list stay in their chunk until the
+      arena is freed */
+   uClass = uSize / GRANULE - 1;
+   if (uClass >= NUM_SIZE_CLASSES)
+      return;
+
+   psBlock = (struct SymTableArenaBlock*)pvBlock;
+   psBlock->psNextBlock = oArena->apsFreeBlocks[uClass];
+   oArena->apsFreeBlocks[uClass] = psBlock;
+}
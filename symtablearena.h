@@ -0,0 +1,49 @@
+/*--------------------------------------------------------------------*/
+/* symtablearena.h                                                    */
+/* Author: Ndongo Njie                                                */
+/* This file, symtablearena.h, defines the functions used to carve    */
+/* symbol table nodes out of large chunks of memory.                  */
+/*--------------------------------------------------------------------*/
+
+#ifndef SymTableArena_INCLUDED
+#define SymTableArena_INCLUDED
+#include <stddef.h>
+
+/* A SymTableArena_T hands out blocks carved from large chunks. Blocks
+   given back are kept on per-size free lists for reuse, and every
+   chunk is released at once when the arena is freed. */
+
+typedef struct SymTableArena *SymTableArena_T;
+
+/*--------------------------------------------------------------------*/
+
+/* Return a new SymTableArena_T object that owns no chunks, or NULL if
+   insufficient memory is available. */
+
+SymTableArena_T SymTableArena_new(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Free oArena and every chunk it owns, which frees every block that
+   was ever allocated from it. */
+
+void SymTableArena_free(SymTableArena_T oArena);
+
+/*--------------------------------------------------------------------*/
+
+/* Return a block of at least uSize bytes from oArena, suitably aligned
+   for any symbol table node, or NULL if insufficient memory is
+   available. */
+
+void *SymTableArena_alloc(SymTableArena_T oArena, size_t uSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Give pvBlock, which SymTableArena_alloc returned for a request of
+   uSize bytes, back to oArena so that a later allocation of the same
+   size can reuse it. */
+
+void SymTableArena_release(SymTableArena_T oArena, void *pvBlock,
+   size_t uSize);
+
+#endif
@@ -0,0 +1,1146 @@
+/*---------------------------------------------------------------------*/
+/* symtableart.c                                                       */
+/* Author: Ndongo Njie                                                 */
+/* This file, symtableart.c, implements symbol table using an adaptive */
+/* radix tree with path compression, which shares the common prefixes  */
+/* of the keys and keeps the bindings in key order.                    */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symtable.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------*/
+
+/* The kinds of tree entries. An inner node of each size holds up to 4,
+   16, 48 or 256 children, and is replaced by the next size up or down
+   as children come and go. */
+enum {NODE_4, NODE_16, NODE_48, NODE_256, NODE_LEAF};
+
+/* The number of bytes of a compressed path kept in its node, chosen to
+   fill out the node header. Longer paths are skipped while searching
+   and checked against the key of the leaf found. */
+enum {MAX_PREFIX_LENGTH = 13};
+
+/* A shrinking node is replaced by the next size down once it has this
+   few children, a little below that size's capacity so that a node
+   whose count goes up and down by one is not reallocated each time */
+enum {SHRINK_256 = 37, SHRINK_48 = 12, SHRINK_16 = 3};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTableNode begins every inner node. Each key is followed by its
+   terminating '\0', so no key is a prefix of another and every binding
+   ends up in a leaf. The tree is walked one key byte per level, except
+   that a node whose keys all share some more bytes stores those bytes
+   as its prefix and covers them in one step. */
+
+struct SymTableNode
+{
+   /* NODE_4, NODE_16, NODE_48 or NODE_256 */
+   unsigned char ucType;
+
+   /* The first bytes of the prefix, up to MAX_PREFIX_LENGTH of them */
+   unsigned char aucPrefix[MAX_PREFIX_LENGTH];
+
+   /* The number of children, at most 256 */
+   unsigned short numChildren;
+
+   /* The number of bytes the keys below share after the bytes that
+      led to the node */
+   size_t uPrefixLength;
+};
+
+/* Each child is an inner node or a SymTableLeaf, told apart by the
+   ucType at the start of both. Node4 and Node16 keep their key bytes
+   sorted, with the child for aucKeys[i] at apvChildren[i]. */
+
+struct SymTableNode4
+{
+   struct SymTableNode sHeader;
+   unsigned char aucKeys[4];
+   void *apvChildren[4];
+};
+
+struct SymTableNode16
+{
+   struct SymTableNode sHeader;
+   unsigned char aucKeys[16];
+   void *apvChildren[16];
+};
+
+/* The child for byte b of a Node48 is apvChildren[aucChildIndex[b]-1],
+   or there is none if aucChildIndex[b] is 0. */
+
+struct SymTableNode48
+{
+   struct SymTableNode sHeader;
+   unsigned char aucChildIndex[256];
+   void *apvChildren[48];
+};
+
+struct SymTableNode256
+{
+   struct SymTableNode sHeader;
+   void *apvChildren[256];
+};
+
+/* A SymTableLeaf holds one binding, with its key stored in the same
+   block, so that a binding costs a single allocation. */
+
+struct SymTableLeaf
+{
+   /* NODE_LEAF */
+   unsigned char ucType;
+
+   /* The value */
+   const void *pvValue;
+
+   /* The key */
+   char acKey[];
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTable points to the root of its tree. */
+
+struct SymTable
+{
+   /* The root, or NULL if the table is empty */
+   void *pvRoot;
+
+   /* The number of Bindings */
+   size_t numBindings;
+};
+
+/*---------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if pvEntry is a SymTableLeaf, or 0 (FALSE) if it is
+   an inner node. */
+
+static int SymTable_isLeaf(const void *pvEntry)
+{
+   assert(pvEntry != NULL);
+   return *(const unsigned char*)pvEntry == NODE_LEAF;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if psLeaf's key is pcKey, or 0 (FALSE) otherwise. */
+
+static int SymTable_leafMatches(const struct SymTableLeaf *psLeaf,
+   const char *pcKey)
+{
+   assert(psLeaf != NULL);
+   assert(pcKey != NULL);
+
+   return strcmp(psLeaf->acKey, pcKey) == 0;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return a new leaf binding pcKey, of length uKeyLength, to pvValue,
+   or NULL if insufficient memory is available. */
+
+static struct SymTableLeaf *SymTable_newLeaf(const char *pcKey,
+   size_t uKeyLength, const void *pvValue)
+{
+   struct SymTableLeaf *psLeaf;
+
+   assert(pcKey != NULL);
+
+   psLeaf = (struct SymTableLeaf*)
+      malloc(sizeof(struct SymTableLeaf) + uKeyLength + 1);
+   if (psLeaf == NULL)
+      return NULL;
+
+   psLeaf->ucType = NODE_LEAF;
+   psLeaf->pvValue = pvValue;
+   memcpy(psLeaf->acKey, pcKey, uKeyLength + 1);
+   return psLeaf;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return a new inner node of type ucType with no children and no
+   prefix, or NULL if insufficient memory is available. */
+
+static struct SymTableNode *SymTable_newNode(unsigned char ucType)
+{
+   struct SymTableNode *psNode;
+   size_t uSize;
+
+   switch (ucType)
+   {
+      case NODE_4:
+         uSize = sizeof(struct SymTableNode4);
+         break;
+      case NODE_16:
+         uSize = sizeof(struct SymTableNode16);
+         break;
+      case NODE_48:
+         uSize = sizeof(struct SymTableNode48);
+         break;
+      default:
+         assert(ucType == NODE_256);
+         uSize = sizeof(struct SymTableNode256);
+         break;
+   }
+
+   psNode = (struct SymTableNode*)calloc(1, uSize);
+   if (psNode == NULL)
+      return NULL;
+
+   psNode->ucType = ucType;
+   return psNode;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the address of the slot holding psNode's child for ucByte,
+   or NULL if it has none. */
+
+static void **SymTable_findChild(struct SymTableNode *psNode,
+   unsigned char ucByte)
+{
+   struct SymTableNode4 *psNode4;
+   struct SymTableNode16 *psNode16;
+   struct SymTableNode48 *psNode48;
+   struct SymTableNode256 *psNode256;
+   size_t u;
+
+   assert(psNode != NULL);
+
+   switch (psNode->ucType)
+   {
+      case NODE_4:
+         psNode4 = (struct SymTableNode4*)psNode;
+         for (u = 0; u < psNode->numChildren; u++)
+            if (psNode4->aucKeys[u] == ucByte)
+               return &psNode4->apvChildren[u];
+         return NULL;
+
+      case NODE_16:
+         psNode16 = (struct SymTableNode16*)psNode;
+         for (u = 0; u < psNode->numChildren &&
+              psNode16->aucKeys[u] <= ucByte; u++)
+            if (psNode16->aucKeys[u] == ucByte)
+               return &psNode16->apvChildren[u];
+         return NULL;
+
+      case NODE_48:
+         psNode48 = (struct SymTableNode48*)psNode;
+         if (psNode48->aucChildIndex[ucByte] == 0)
+            return NULL;
+         return &psNode48->apvChildren[psNode48->aucChildIndex[ucByte]
+            - 1];
+
+      default:
+         psNode256 = (struct SymTableNode256*)psNode;
+         if (psNode256->apvChildren[ucByte] == NULL)
+            return NULL;
+         return &psNode256->apvChildren[ucByte];
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the leaf with the smallest key below pvEntry. */
+
+static const struct SymTableLeaf *SymTable_minimum(const void *pvEntry)
+{
+   const struct SymTableNode *psNode;
+   const struct SymTableNode48 *psNode48;
+   const struct SymTableNode256 *psNode256;
+   size_t u;
+
+   assert(pvEntry != NULL);
+
+   while (! SymTable_isLeaf(pvEntry))
+   {
+      psNode = (const struct SymTableNode*)pvEntry;
+      switch (psNode->ucType)
+      {
+         case NODE_4:
+            pvEntry = ((const struct SymTableNode4*)psNode)->apvChildren[0];
+            break;
+         case NODE_16:
+            pvEntry =
+               ((const struct SymTableNode16*)psNode)->apvChildren[0];
+            break;
+         case NODE_48:
+            psNode48 = (const struct SymTableNode48*)psNode;
+            for (u = 0; psNode48->aucChildIndex[u] == 0; u++)
+               ;
+            pvEntry = psNode48->apvChildren[psNode48->aucChildIndex[u] - 1];
+            break;
+         default:
+            psNode256 = (const struct SymTableNode256*)psNode;
+            for (u = 0; psNode256->apvChildren[u] == NULL; u++)
+               ;
+            pvEntry = psNode256->apvChildren[u];
+            break;
+      }
+   }
+   return (const struct SymTableLeaf*)pvEntry;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return how many bytes of psNode's stored prefix match the bytes of
+   pcKey from uDepth on, stopping at uLimit. Only the bytes kept in the
+   node are compared. */
+
+static size_t SymTable_checkPrefix(const struct SymTableNode *psNode,
+   const char *pcKey, size_t uLimit, size_t uDepth)
+{
+   size_t uStored;
+   size_t u;
+
+   assert(psNode != NULL);
+   assert(pcKey != NULL);
+
+   uStored = psNode->uPrefixLength;
+   if (uStored > MAX_PREFIX_LENGTH)
+      uStored = MAX_PREFIX_LENGTH;
+
+   for (u = 0; u < uStored && uDepth + u < uLimit; u++)
+      if (psNode->aucPrefix[u] != (unsigned char)pcKey[uDepth + u])
+         return u;
+   return u;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return how many bytes of psNode's whole prefix, which starts at
+   uDepth, match the bytes of pcKey from uDepth on, stopping at
+   uLimit. Bytes past those kept in the node are read from a leaf
+   below it. */
+
+static size_t SymTable_prefixMismatch(const struct SymTableNode *psNode,
+   const char *pcKey, size_t uLimit, size_t uDepth)
+{
+   const struct SymTableLeaf *psLeaf;
+   size_t u;
+
+   assert(psNode != NULL);
+   assert(pcKey != NULL);
+
+   u = SymTable_checkPrefix(psNode, pcKey, uLimit, uDepth);
+   if (u < MAX_PREFIX_LENGTH || psNode->uPrefixLength <= MAX_PREFIX_LENGTH)
+      return u;
+
+   psLeaf = SymTable_minimum(psNode);
+   for (; u < psNode->uPrefixLength && uDepth + u < uLimit; u++)
+      if (psLeaf->acKey[uDepth + u] != pcKey[uDepth + u])
+         return u;
+   return u;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Make psNode's stored prefix the first bytes of the uLength bytes at
+   pcBytes, and its prefix length uLength. */
+
+static void SymTable_setPrefix(struct SymTableNode *psNode,
+   const char *pcBytes, size_t uLength)
+{
+   assert(psNode != NULL);
+   assert(pcBytes != NULL);
+
+   psNode->uPrefixLength = uLength;
+   if (uLength > MAX_PREFIX_LENGTH)
+      uLength = MAX_PREFIX_LENGTH;
+   memcpy(psNode->aucPrefix, pcBytes, uLength);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the leaf for the uKeyLength characters at pcKey, or NULL if
+   oSymTable has none. The stored prefix bytes of each node on the way
+   are checked, and the key of the leaf reached is compared in full,
+   so the cost grows with the key's length and not with the number of
+   bindings. */
+
+static struct SymTableLeaf *SymTable_find(SymTable_T oSymTable,
+   const char *pcKey, size_t uKeyLength)
+{
+   struct SymTableNode *psNode;
+   void *pvEntry;
+   void **ppvChild;
+   size_t uMatched;
+   size_t uDepth = 0;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   pvEntry = oSymTable->pvRoot;
+   while (pvEntry != NULL)
+   {
+      if (SymTable_isLeaf(pvEntry))
+      {
+         if (SymTable_leafMatches((struct SymTableLeaf*)pvEntry, pcKey))
+            return (struct SymTableLeaf*)pvEntry;
+         return NULL;
+      }
+
+      psNode = (struct SymTableNode*)pvEntry;
+      if (psNode->uPrefixLength > 0)
+      {
+         uMatched = SymTable_checkPrefix(psNode, pcKey, uKeyLength + 1,
+            uDepth);
+         if (uMatched < psNode->uPrefixLength &&
+             uMatched < MAX_PREFIX_LENGTH)
+            return NULL;
+         uDepth += psNode->uPrefixLength;
+         if (uDepth > uKeyLength)
+            return NULL;
+      }
+
+      ppvChild = SymTable_findChild(psNode,
+         (unsigned char)pcKey[uDepth]);
+      if (ppvChild == NULL)
+         return NULL;
+      pvEntry = *ppvChild;
+      uDepth++;
+   }
+   return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Add pvChild as the child for ucByte of the node at *ppvNode, which
+   has none for ucByte, replacing the node with the next size up if it
+   is full. Return 1 (TRUE), or 0 (FALSE) if insufficient memory is
+   available, in which case nothing changes. */
+
+static int SymTable_addChild(void **ppvNode, unsigned char ucByte,
+   void *pvChild)
+{
+   struct SymTableNode *psNode;
+   struct SymTableNode *psBigger;
+   struct SymTableNode4 *psNode4;
+   struct SymTableNode16 *psNode16;
+   struct SymTableNode48 *psNode48;
+   struct SymTableNode256 *psNode256;
+   unsigned char *pucKeys;
+   void **ppvChildren;
+   size_t uCapacity;
+   size_t u;
+
+   assert(ppvNode != NULL);
+   assert(pvChild != NULL);
+
+   psNode = (struct SymTableNode*)*ppvNode;
+   switch (psNode->ucType)
+   {
+      case NODE_4:
+      case NODE_16:
+         if (psNode->ucType == NODE_4)
+         {
+            psNode4 = (struct SymTableNode4*)psNode;
+            pucKeys = psNode4->aucKeys;
+            ppvChildren = psNode4->apvChildren;
+            uCapacity = 4;
+         }
+         else
+         {
+            psNode16 = (struct SymTableNode16*)psNode;
+            pucKeys = psNode16->aucKeys;
+            ppvChildren = psNode16->apvChildren;
+            uCapacity = 16;
+         }
+
+         if (psNode->numChildren < uCapacity)
+         {
+            for (u = 0; u < psNode->numChildren && pucKeys[u] < ucByte;
+                 u++)
+               ;
+            memmove(&pucKeys[u + 1], &pucKeys[u],
+               psNode->numChildren - u);
+            memmove(&ppvChildren[u + 1], &ppvChildren[u],
+               (psNode->numChildren - u) * sizeof(void*));
+            pucKeys[u] = ucByte;
+            ppvChildren[u] = pvChild;
+            psNode->numChildren++;
+            return 1;
+         }
+
+         if (psNode->ucType == NODE_4)
+         {
+            psBigger = SymTable_newNode(NODE_16);
+            if (psBigger == NULL)
+               return 0;
+            *psBigger = *psNode;
+            psBigger->ucType = NODE_16;
+            psNode16 = (struct SymTableNode16*)psBigger;
+            memcpy(psNode16->aucKeys, pucKeys, uCapacity);
+            memcpy(psNode16->apvChildren, ppvChildren,
+               uCapacity * sizeof(void*));
+         }
+         else
+         {
+            psBigger = SymTable_newNode(NODE_48);
+            if (psBigger == NULL)
+               return 0;
+            *psBigger = *psNode;
+            psBigger->ucType = NODE_48;
+            psNode48 = (struct SymTableNode48*)psBigger;
+            for (u = 0; u < uCapacity; u++)
+            {
+               psNode48->apvChildren[u] = ppvChildren[u];
+               psNode48->aucChildIndex[pucKeys[u]] = (unsigned char)(u + 1);
+            }
+         }
+         break;
+
+      case NODE_48:
+         psNode48 = (struct SymTableNode48*)psNode;
+         if (psNode->numChildren < 48)
+         {
+            for (u = 0; psNode48->apvChildren[u] != NULL; u++)
+               ;
+            psNode48->apvChildren[u] = pvChild;
+            psNode48->aucChildIndex[ucByte] = (unsigned char)(u + 1);
+            psNode->numChildren++;
+            return 1;
+         }
+
+         psBigger = SymTable_newNode(NODE_256);
+         if (psBigger == NULL)
+            return 0;
+         *psBigger = *psNode;
+         psBigger->ucType = NODE_256;
+         psNode256 = (struct SymTableNode256*)psBigger;
+         for (u = 0; u < 256; u++)
+            if (psNode48->aucChildIndex[u] != 0)
+               psNode256->apvChildren[u] =
+                  psNode48->apvChildren[psNode48->aucChildIndex[u] - 1];
+         break;
+
+      default:
+         psNode256 = (struct SymTableNode256*)psNode;
+         psNode256->apvChildren[ucByte] = pvChild;
+         psNode->numChildren++;
+         return 1;
+   }
+
+   /* The bigger node has room */
+   free(psNode);
+   *ppvNode = psBigger;
+   return SymTable_addChild(ppvNode, ucByte, pvChild);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Replace the Node4 at *ppvNode, which has one child left, with that
+   child, moving the node's prefix and the child's key byte in front
+   of the child's own prefix. */
+
+static void SymTable_collapse(void **ppvNode)
+{
+   struct SymTableNode4 *psNode4;
+   struct SymTableNode *psChild;
+   unsigned char aucPrefix[MAX_PREFIX_LENGTH];
+   size_t uStored;
+   size_t u;
+
+   assert(ppvNode != NULL);
+
+   psNode4 = (struct SymTableNode4*)*ppvNode;
+   assert(psNode4->sHeader.numChildren == 1);
+
+   if (! SymTable_isLeaf(psNode4->apvChildren[0]))
+   {
+      psChild = (struct SymTableNode*)psNode4->apvChildren[0];
+
+      /* The stored bytes of the merged prefix: the node's, its key byte
+         and then the child's, as many as fit */
+      uStored = psNode4->sHeader.uPrefixLength;
+      if (uStored > MAX_PREFIX_LENGTH)
+         uStored = MAX_PREFIX_LENGTH;
+      memcpy(aucPrefix, psNode4->sHeader.aucPrefix, uStored);
+      if (uStored < MAX_PREFIX_LENGTH)
+         aucPrefix[uStored++] = psNode4->aucKeys[0];
+      for (u = 0; uStored < MAX_PREFIX_LENGTH &&
+           u < psChild->uPrefixLength && u < MAX_PREFIX_LENGTH; u++)
+         aucPrefix[uStored++] = psChild->aucPrefix[u];
+
+      memcpy(psChild->aucPrefix, aucPrefix, uStored);
+      psChild->uPrefixLength += psNode4->sHeader.uPrefixLength + 1;
+   }
+
+   *ppvNode = psNode4->apvChildren[0];
+   free(psNode4);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Remove the child for ucByte, which must exist, from the node at
+   *ppvNode, replacing the node with the next size down, or with its
+   last child, once it has few enough children. A node that cannot be
+   replaced for lack of memory is simply kept. */
+
+static void SymTable_removeChild(void **ppvNode, unsigned char ucByte)
+{
+   struct SymTableNode *psNode;
+   struct SymTableNode *psSmaller;
+   struct SymTableNode4 *psNode4;
+   struct SymTableNode16 *psNode16;
+   struct SymTableNode48 *psNode48;
+   struct SymTableNode256 *psNode256;
+   unsigned char *pucKeys;
+   void **ppvChildren;
+   size_t u;
+   size_t v;
+
+   assert(ppvNode != NULL);
+
+   psNode = (struct SymTableNode*)*ppvNode;
+   switch (psNode->ucType)
+   {
+      case NODE_4:
+      case NODE_16:
+         if (psNode->ucType == NODE_4)
+         {
+            psNode4 = (struct SymTableNode4*)psNode;
+            pucKeys = psNode4->aucKeys;
+            ppvChildren = psNode4->apvChildren;
+         }
+         else
+         {
+            psNode16 = (struct SymTableNode16*)psNode;
+            pucKeys = psNode16->aucKeys;
+            ppvChildren = psNode16->apvChildren;
+         }
+
+         for (u = 0; pucKeys[u] != ucByte; u++)
+            ;
+         memmove(&pucKeys[u], &pucKeys[u + 1],
+            psNode->numChildren - u - 1);
+         memmove(&ppvChildren[u], &ppvChildren[u + 1],
+            (psNode->numChildren - u - 1) * sizeof(void*));
+         psNode->numChildren--;
+
+         if (psNode->ucType == NODE_4)
+         {
+            if (psNode->numChildren == 1)
+               SymTable_collapse(ppvNode);
+            return;
+         }
+         if (psNode->numChildren != SHRINK_16)
+            return;
+         psSmaller = SymTable_newNode(NODE_4);
+         if (psSmaller == NULL)
+            return;
+         *psSmaller = *psNode;
+         psSmaller->ucType = NODE_4;
+         psNode4 = (struct SymTableNode4*)psSmaller;
+         memcpy(psNode4->aucKeys, pucKeys, SHRINK_16);
+         memcpy(psNode4->apvChildren, ppvChildren,
+            SHRINK_16 * sizeof(void*));
+         break;
+
+      case NODE_48:
+         psNode48 = (struct SymTableNode48*)psNode;
+         psNode48->apvChildren[psNode48->aucChildIndex[ucByte] - 1] = NULL;
+         psNode48->aucChildIndex[ucByte] = 0;
+         psNode->numChildren--;
+
+         if (psNode->numChildren != SHRINK_48)
+            return;
+         psSmaller = SymTable_newNode(NODE_16);
+         if (psSmaller == NULL)
+            return;
+         *psSmaller = *psNode;
+         psSmaller->ucType = NODE_16;
+         psNode16 = (struct SymTableNode16*)psSmaller;
+         for (u = 0, v = 0; u < 256; u++)
+            if (psNode48->aucChildIndex[u] != 0)
+            {
+               psNode16->aucKeys[v] = (unsigned char)u;
+               psNode16->apvChildren[v++] =
+                  psNode48->apvChildren[psNode48->aucChildIndex[u] - 1];
+            }
+         break;
+
+      default:
+         psNode256 = (struct SymTableNode256*)psNode;
+         psNode256->apvChildren[ucByte] = NULL;
+         psNode->numChildren--;
+
+         if (psNode->numChildren != SHRINK_256)
+            return;
+         psSmaller = SymTable_newNode(NODE_48);
+         if (psSmaller == NULL)
+            return;
+         *psSmaller = *psNode;
+         psSmaller->ucType = NODE_48;
+         psNode48 = (struct SymTableNode48*)psSmaller;
+         for (u = 0, v = 0; u < 256; u++)
+            if (psNode256->apvChildren[u] != NULL)
+            {
+               psNode48->apvChildren[v] = psNode256->apvChildren[u];
+               psNode48->aucChildIndex[u] = (unsigned char)(++v);
+            }
+         break;
+   }
+
+   free(psNode);
+   *ppvNode = psSmaller;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Insert psLeaf, whose key of length uKeyLength is not in the subtree
+   at *ppvEntry, into that subtree, whose entries all share the first
+   uDepth bytes of the key. Return 1 (TRUE), or 0 (FALSE) if
+   insufficient memory is available, in which case nothing changes. */
+
+static int SymTable_insert(void **ppvEntry, struct SymTableLeaf *psLeaf,
+   size_t uKeyLength, size_t uDepth)
+{
+   struct SymTableNode *psNode;
+   struct SymTableNode *psNewNode;
+   const struct SymTableLeaf *psOther;
+   const char *pcKey;
+   size_t uLimit;
+   size_t uCommon;
+   void **ppvChild;
+
+   assert(ppvEntry != NULL);
+   assert(psLeaf != NULL);
+
+   pcKey = psLeaf->acKey;
+   uLimit = uKeyLength + 1;
+   for (;;)
+   {
+      if (*ppvEntry == NULL)
+      {
+         *ppvEntry = psLeaf;
+         return 1;
+      }
+
+      if (SymTable_isLeaf(*ppvEntry))
+      {
+         /* Two leaves: put a node where they part */
+         psOther = (const struct SymTableLeaf*)*ppvEntry;
+         for (uCommon = 0; psOther->acKey[uDepth + uCommon] ==
+              pcKey[uDepth + uCommon]; uCommon++)
+            ;
+         psNewNode = SymTable_newNode(NODE_4);
+         if (psNewNode == NULL)
+            return 0;
+         SymTable_setPrefix(psNewNode, pcKey + uDepth, uCommon);
+         SymTable_addChild((void**)&psNewNode,
+            (unsigned char)psOther->acKey[uDepth + uCommon], *ppvEntry);
+         SymTable_addChild((void**)&psNewNode,
+            (unsigned char)pcKey[uDepth + uCommon], psLeaf);
+         *ppvEntry = psNewNode;
+         return 1;
+      }
+
+      psNode = (struct SymTableNode*)*ppvEntry;
+      if (psNode->uPrefixLength > 0)
+      {
+         uCommon = SymTable_prefixMismatch(psNode, pcKey, uLimit, uDepth);
+         if (uCommon < psNode->uPrefixLength)
+         {
+            /* The key leaves the compressed path part way: split the
+               path with a node where they part */
+            psNewNode = SymTable_newNode(NODE_4);
+            if (psNewNode == NULL)
+               return 0;
+            SymTable_setPrefix(psNewNode, pcKey + uDepth, uCommon);
+
+            psOther = SymTable_minimum(psNode);
+            SymTable_addChild((void**)&psNewNode,
+               (unsigned char)psOther->acKey[uDepth + uCommon], psNode);
+            SymTable_addChild((void**)&psNewNode,
+               (unsigned char)pcKey[uDepth + uCommon], psLeaf);
+            SymTable_setPrefix(psNode,
+               psOther->acKey + uDepth + uCommon + 1,
+               psNode->uPrefixLength - uCommon - 1);
+            *ppvEntry = psNewNode;
+            return 1;
+         }
+         uDepth += psNode->uPrefixLength;
+      }
+
+      ppvChild = SymTable_findChild(psNode, (unsigned char)pcKey[uDepth]);
+      if (ppvChild == NULL)
+         return SymTable_addChild(ppvEntry, (unsigned char)pcKey[uDepth],
+            psLeaf);
+      ppvEntry = ppvChild;
+      uDepth++;
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Detach and return the leaf for the uKeyLength characters at pcKey
+   from the subtree at *ppvEntry, whose entries all share the first
+   uDepth bytes of the key, or return NULL if it has none. */
+
+static struct SymTableLeaf *SymTable_detach(void **ppvEntry,
+   const char *pcKey, size_t uKeyLength, size_t uDepth)
+{
+   struct SymTableNode *psNode;
+   struct SymTableLeaf *psLeaf;
+   void **ppvChild;
+
+   assert(ppvEntry != NULL);
+   assert(pcKey != NULL);
+
+   if (*ppvEntry == NULL)
+      return NULL;
+
+   /* Only a root can be a leaf here; deeper leaves are removed from
+      their parents below */
+   if (SymTable_isLeaf(*ppvEntry))
+   {
+      psLeaf = (struct SymTableLeaf*)*ppvEntry;
+      if (! SymTable_leafMatches(psLeaf, pcKey))
+         return NULL;
+      *ppvEntry = NULL;
+      return psLeaf;
+   }
+
+   for (;;)
+   {
+      psNode = (struct SymTableNode*)*ppvEntry;
+      if (psNode->uPrefixLength > 0)
+      {
+         if (SymTable_prefixMismatch(psNode, pcKey, uKeyLength + 1,
+                uDepth) < psNode->uPrefixLength)
+            return NULL;
+         uDepth += psNode->uPrefixLength;
+      }
+
+      ppvChild = SymTable_findChild(psNode, (unsigned char)pcKey[uDepth]);
+      if (ppvChild == NULL)
+         return NULL;
+
+      if (SymTable_isLeaf(*ppvChild))
+      {
+         psLeaf = (struct SymTableLeaf*)*ppvChild;
+         if (! SymTable_leafMatches(psLeaf, pcKey))
+            return NULL;
+         SymTable_removeChild(ppvEntry, (unsigned char)pcKey[uDepth]);
+         return psLeaf;
+      }
+      ppvEntry = ppvChild;
+      uDepth++;
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Free the subtree at pvEntry, leaves included. */
+
+static void SymTable_freeEntry(void *pvEntry)
+{
+   struct SymTableNode *psNode;
+   struct SymTableNode48 *psNode48;
+   void **ppvChildren;
+   size_t uSlots;
+   size_t u;
+
+   assert(pvEntry != NULL);
+
+   if (SymTable_isLeaf(pvEntry))
+   {
+      free(pvEntry);
+      return;
+   }
+
+   psNode = (struct SymTableNode*)pvEntry;
+   switch (psNode->ucType)
+   {
+      case NODE_4:
+         ppvChildren = ((struct SymTableNode4*)psNode)->apvChildren;
+         uSlots = psNode->numChildren;
+         break;
+      case NODE_16:
+         ppvChildren = ((struct SymTableNode16*)psNode)->apvChildren;
+         uSlots = psNode->numChildren;
+         break;
+      case NODE_48:
+         psNode48 = (struct SymTableNode48*)psNode;
+         ppvChildren = psNode48->apvChildren;
+         uSlots = 48;
+         break;
+      default:
+         ppvChildren = ((struct SymTableNode256*)psNode)->apvChildren;
+         uSlots = 256;
+         break;
+   }
+   for (u = 0; u < uSlots; u++)
+      if (ppvChildren[u] != NULL)
+         SymTable_freeEntry(ppvChildren[u]);
+   free(psNode);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Apply pfApply, with pvExtra, to each binding below pvEntry, in
+   ascending key order. */
+
+static void SymTable_mapEntry(const void *pvEntry,
+   void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+   void *pvExtra)
+{
+   const struct SymTableLeaf *psLeaf;
+   const struct SymTableNode *psNode;
+   const struct SymTableNode48 *psNode48;
+   const struct SymTableNode256 *psNode256;
+   void *const *ppvChildren;
+   size_t u;
+
+   assert(pvEntry != NULL);
+   assert(pfApply != NULL);
+
+   if (SymTable_isLeaf(pvEntry))
+   {
+      psLeaf = (const struct SymTableLeaf*)pvEntry;
+      (*pfApply)(psLeaf->acKey, (void*)psLeaf->pvValue, pvExtra);
+      return;
+   }
+
+   psNode = (const struct SymTableNode*)pvEntry;
+   switch (psNode->ucType)
+   {
+      case NODE_4:
+      case NODE_16:
+         if (psNode->ucType == NODE_4)
+            ppvChildren =
+               ((const struct SymTableNode4*)psNode)->apvChildren;
+         else
+            ppvChildren =
+               ((const struct SymTableNode16*)psNode)->apvChildren;
+         for (u = 0; u < psNode->numChildren; u++)
+            SymTable_mapEntry(ppvChildren[u], pfApply, pvExtra);
+         break;
+
+      case NODE_48:
+         psNode48 = (const struct SymTableNode48*)psNode;
+         for (u = 0; u < 256; u++)
+            if (psNode48->aucChildIndex[u] != 0)
+               SymTable_mapEntry(psNode48->apvChildren[
+                  psNode48->aucChildIndex[u] - 1], pfApply, pvExtra);
+         break;
+
+      default:
+         psNode256 = (const struct SymTableNode256*)psNode;
+         for (u = 0; u < 256; u++)
+            if (psNode256->apvChildren[u] != NULL)
+               SymTable_mapEntry(psNode256->apvChildren[u], pfApply,
+                  pvExtra);
+         break;
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->pvRoot = NULL;
+   oSymTable->numBindings = 0;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+
+   if (oSymTable->pvRoot != NULL)
+      SymTable_freeEntry(oSymTable->pvRoot);
+   free(oSymTable);
+}
+
+/*---------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+   return oSymTable->numBindings;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableLeaf *psLeaf;
+   size_t uKeyLength;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyLength = strlen(pcKey);
+   if (SymTable_find(oSymTable, pcKey, uKeyLength) != NULL)
+      return 0;
+
+   psLeaf = SymTable_newLeaf(pcKey, uKeyLength, pvValue);
+   if (psLeaf == NULL)
+      return 0;
+
+   if (! SymTable_insert(&oSymTable->pvRoot, psLeaf, uKeyLength, 0))
+   {
+      free(psLeaf);
+      return 0;
+   }
+
+   oSymTable->numBindings++;
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableLeaf *psLeaf;
+   const void *oldValue;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   psLeaf = SymTable_find(oSymTable, pcKey, strlen(pcKey));
+   if (psLeaf == NULL)
+      return NULL;
+
+   oldValue = psLeaf->pvValue;
+   psLeaf->pvValue = pvValue;
+   return (void*)oldValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_find(oSymTable, pcKey, strlen(pcKey)) != NULL;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableLeaf *psLeaf;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   psLeaf = SymTable_find(oSymTable, pcKey, strlen(pcKey));
+   if (psLeaf == NULL)
+      return NULL;
+   return (void*)psLeaf->pvValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableLeaf *psLeaf;
+   const void *value;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   psLeaf = SymTable_detach(&oSymTable->pvRoot, pcKey, strlen(pcKey), 0);
+   if (psLeaf == NULL)
+      return NULL;
+
+   value = psLeaf->pvValue;
+   free(psLeaf);
+   oSymTable->numBindings--;
+   return (void*)value;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   if (oSymTable->pvRoot != NULL)
+      SymTable_mapEntry(oSymTable->pvRoot, pfApply, (void*)pvExtra);
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_mapPrefix(SymTable_T oSymTable, const char *pcPrefix,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   const struct SymTableLeaf *psLeaf;
+   struct SymTableNode *psNode;
+   void *pvEntry;
+   void **ppvChild;
+   size_t uPrefixLength;
+   size_t uMatched;
+   size_t uDepth = 0;
+
+   assert(oSymTable != NULL);
+   assert(pcPrefix != NULL);
+   assert(pfApply != NULL);
+
+   /* Walk down to the first entry whose keys all start with pcPrefix,
+      then visit its whole subtree */
+   uPrefixLength = strlen(pcPrefix);
+   pvEntry = oSymTable->pvRoot;
+   while (pvEntry != NULL)
+   {
+      if (SymTable_isLeaf(pvEntry))
+      {
+         psLeaf = (const struct SymTableLeaf*)pvEntry;
+         if (strncmp(psLeaf->acKey, pcPrefix, uPrefixLength) == 0)
+            (*pfApply)(psLeaf->acKey, (void*)psLeaf->pvValue,
+               (void*)pvExtra);
+         return;
+      }
+      if (uDepth == uPrefixLength)
+         break;
+
+      psNode = (struct SymTableNode*)pvEntry;
+      if (psNode->uPrefixLength > 0)
+      {
+         uMatched = SymTable_prefixMismatch(psNode, pcPrefix,
+            uPrefixLength, uDepth);
+
+         /* The compressed path may cover the rest of pcPrefix */
+         if (uDepth + uMatched == uPrefixLength)
+            break;
+         if (uMatched < psNode->uPrefixLength)
+            return;
+         uDepth += psNode->uPrefixLength;
+      }
+
+      ppvChild = SymTable_findChild(psNode,
+         (unsigned char)pcPrefix[uDepth]);
+      if (ppvChild == NULL)
+         return;
+      pvEntry = *ppvChild;
+      uDepth++;
+   }
+
+   if (pvEntry != NULL)
+      SymTable_mapEntry(pvEntry, pfApply, (void*)pvExtra);
+}
@@ -0,0 +1,722 @@
+/*---------------------------------------------------------------------*/
+/* symtableconcurrent.c                                                */
+/* Author: Ndongo Njie                                                 */
+/* This file, symtableconcurrent.c, implements a symbol table that     */
+/* many threads can use at once: a hash table whose buckets are        */
+/* guarded by striped reader-writer locks, with an optional lock-free  */
+/* read path.                                                          */
+/*---------------------------------------------------------------------*/
+
+/* pthread_rwlock_t is a POSIX.1-2001 feature */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "symtable.h"
+#include "symtableepoch.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------*/
+
+/* The number of locks. Bucket i is guarded by lock i % NUM_STRIPES.
+   Must be a power of two. */
+enum {NUM_STRIPES = 64};
+
+/* The number of buckets in a new table. Must be a power of two and at
+   least NUM_STRIPES. */
+static const size_t INITIAL_BUCKET_COUNT = 1024;
+
+/* A stripe's buckets are doubled once the stripe holds more than this
+   many bindings per bucket. */
+static const size_t MAX_LOAD_FACTOR = 1;
+
+/*---------------------------------------------------------------------*/
+
+/* Each item is stored in a SymTableNode.  SymTableNodes are linked to
+   form a list. A node and its copy of the key are a single
+   allocation. pvValue and psNextNode are read and written atomically,
+   because lock-free readers may follow them while a writer changes
+   them. */
+
+struct SymTableNode
+{
+   /* The value */
+   const void *pvValue;
+
+   /* The address of the next SymTableNode. */
+   struct SymTableNode *psNextNode;
+
+   /* The full hash code of the key */
+   size_t uHash;
+
+   /* The length of the key */
+   size_t uKeyLength;
+
+   /* The key, stored inline right after the fields above */
+   char acKey[];
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTableStripe is one lock together with the number of bindings in
+   the buckets it guards. */
+
+struct SymTableStripe
+{
+   /* Held for reading to search the stripe's buckets, and for writing
+      to change them */
+   pthread_rwlock_t sLock;
+
+   /* The number of Bindings/Nodes in the stripe's buckets */
+   size_t numBindings;
+
+   /* Keeps neighbouring stripes off each other's cache lines, so that
+      threads using different stripes do not contend */
+   char acPad[64];
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTableBuckets is a bucket array together with its size, so that
+   a reader gets a consistent pair from a single pointer load. */
+
+struct SymTableBuckets
+{
+   /* The number of buckets, always a power of two */
+   size_t numOfLinkedlists;
+
+   /* The first node of each bucket */
+   struct SymTableNode *psFirstNode[];
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTable is an array of buckets and the stripes that guard them.
+   Both the stripe and the bucket of a key are taken from the low bits
+   of its hash, and the bucket count is a power of two no smaller than
+   NUM_STRIPES, so a key stays in the same stripe as the table grows.
+   Growing takes every stripe for writing. */
+
+struct SymTable
+{
+   /* The bucket array. Replaced only while every stripe is held for
+      writing. */
+   struct SymTableBuckets *psBuckets;
+
+   /* 1 (TRUE) if gets and contains take no lock. Writers then retire
+      removed nodes and old bucket arrays through symtableepoch
+      instead of freeing them, and growing copies the nodes instead of
+      relinking them. */
+   int iLockFreeReads;
+
+   /* The stripes */
+   struct SymTableStripe asStripes[NUM_STRIPES];
+};
+
+/*---------------------------------------------------------------------*/
+
+/* Return the stripe of oSymTable that guards keys whose hash code is
+   uHash. */
+
+static struct SymTableStripe *SymTable_stripeOf(SymTable_T oSymTable,
+   size_t uHash)
+{
+   assert(oSymTable != NULL);
+   return &oSymTable->asStripes[uHash & (NUM_STRIPES - 1)];
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return a new bucket array of uCount empty buckets, or NULL if
+   insufficient memory is available. */
+
+static struct SymTableBuckets *SymTable_newBuckets(size_t uCount)
+{
+   struct SymTableBuckets *psBuckets;
+
+   if (uCount > ((size_t)-1 - offsetof(struct SymTableBuckets,
+       psFirstNode)) / sizeof(struct SymTableNode*))
+      return NULL;
+
+   psBuckets = (struct SymTableBuckets*)calloc(1,
+      offsetof(struct SymTableBuckets, psFirstNode) +
+      uCount * sizeof(struct SymTableNode*));
+   if (psBuckets == NULL)
+      return NULL;
+   psBuckets->numOfLinkedlists = uCount;
+   return psBuckets;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Free the bucket array pvBuckets and every node in it. */
+
+static void SymTable_freeBuckets(void *pvBuckets)
+{
+   struct SymTableBuckets *psBuckets;
+   struct SymTableNode *psCurrentNode;
+   struct SymTableNode *psNextNode;
+   size_t u;
+
+   assert(pvBuckets != NULL);
+
+   psBuckets = (struct SymTableBuckets*)pvBuckets;
+   for (u = 0; u < psBuckets->numOfLinkedlists; u++)
+      for (psCurrentNode = psBuckets->psFirstNode[u];
+           psCurrentNode != NULL;
+           psCurrentNode = psNextNode)
+      {
+         psNextNode = psCurrentNode->psNextNode;
+         free(psCurrentNode);
+      }
+   free(psBuckets);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the address of the link (a bucket head or a psNextNode field)
+   that points to the node of oSymTable whose key is the uKeyLength
+   characters at pcKey, whose hash code is uHash, or NULL if there is
+   no such node. The caller must hold the key's stripe. */
+
+static struct SymTableNode **SymTable_findLink(SymTable_T oSymTable,
+   const char *pcKey, size_t uHash, size_t uKeyLength)
+{
+   struct SymTableBuckets *psBuckets;
+   struct SymTableNode **ppsLink;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   psBuckets = oSymTable->psBuckets;
+   for (ppsLink = &psBuckets->psFirstNode[
+           uHash & (psBuckets->numOfLinkedlists - 1)];
+        *ppsLink != NULL;
+        ppsLink = &(*ppsLink)->psNextNode)
+      if ((*ppsLink)->uHash == uHash &&
+          (*ppsLink)->uKeyLength == uKeyLength &&
+          memcmp(pcKey, (*ppsLink)->acKey, uKeyLength) == 0)
+         return ppsLink;
+   return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the node of oSymTable whose key is the uKeyLength characters
+   at pcKey, whose hash code is uHash, or NULL if there is no such
+   node, without taking any lock. The caller must be inside an epoch
+   read section, and must read the node's value atomically. */
+
+static struct SymTableNode *SymTable_findLockFree(SymTable_T oSymTable,
+   const char *pcKey, size_t uHash, size_t uKeyLength)
+{
+   struct SymTableBuckets *psBuckets;
+   struct SymTableNode *psNode;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   /* Acquire loads pair with the release stores that publish a node or
+      a bucket array, so everything written before publication is
+      seen */
+   psBuckets = __atomic_load_n(&oSymTable->psBuckets, __ATOMIC_ACQUIRE);
+   for (psNode = __atomic_load_n(&psBuckets->psFirstNode[
+           uHash & (psBuckets->numOfLinkedlists - 1)], __ATOMIC_ACQUIRE);
+        psNode != NULL;
+        psNode = __atomic_load_n(&psNode->psNextNode, __ATOMIC_ACQUIRE))
+      if (psNode->uHash == uHash && psNode->uKeyLength == uKeyLength &&
+          memcmp(pcKey, psNode->acKey, uKeyLength) == 0)
+         return psNode;
+   return NULL;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Take every stripe of oSymTable for writing (if iWrite is 1) or for
+   reading (if iWrite is 0). Stripes are always taken in the same order
+   so that two threads doing this cannot deadlock. */
+
+static void SymTable_lockAll(SymTable_T oSymTable, int iWrite)
+{
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   for (u = 0; u < NUM_STRIPES; u++)
+      if (iWrite)
+         pthread_rwlock_wrlock(&oSymTable->asStripes[u].sLock);
+      else
+         pthread_rwlock_rdlock(&oSymTable->asStripes[u].sLock);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Release every stripe of oSymTable. */
+
+static void SymTable_unlockAll(SymTable_T oSymTable)
+{
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   for (u = NUM_STRIPES; u > 0; u--)
+      pthread_rwlock_unlock(&oSymTable->asStripes[u - 1].sLock);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return a copy of psNode, linked to psNextNode, or NULL if
+   insufficient memory is available. */
+
+static struct SymTableNode *SymTable_copyNode(
+   const struct SymTableNode *psNode, struct SymTableNode *psNextNode)
+{
+   struct SymTableNode *psCopy;
+   size_t uSize;
+
+   assert(psNode != NULL);
+
+   uSize = offsetof(struct SymTableNode, acKey) + psNode->uKeyLength + 1;
+   psCopy = (struct SymTableNode*)malloc(uSize);
+   if (psCopy == NULL)
+      return NULL;
+   memcpy(psCopy, psNode, uSize);
+   psCopy->psNextNode = psNextNode;
+   return psCopy;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Double the number of buckets of oSymTable, unless another thread
+   already did so since oSymTable had uSeenCount buckets. The caller
+   must not hold any stripe. If insufficient memory is available,
+   oSymTable keeps its size.
+
+   Relinking nodes in place would send a lock-free reader that is
+   partway along an old chain into a new one, where it could miss its
+   key. A table with lock-free reads therefore fills the new array
+   with copies, publishes it, and retires the old array along with
+   the original nodes. */
+
+static void SymTable_grow(SymTable_T oSymTable, size_t uSeenCount)
+{
+   struct SymTableBuckets *psOldBuckets;
+   struct SymTableBuckets *psNewBuckets;
+   struct SymTableNode *psCurrentNode;
+   struct SymTableNode *psNextNode;
+   struct SymTableNode *psCopy;
+   size_t uNewCount;
+   size_t uIndex;
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   SymTable_lockAll(oSymTable, 1);
+
+   /* Every other writer is now out of the table */
+   psOldBuckets = oSymTable->psBuckets;
+   if (psOldBuckets->numOfLinkedlists != uSeenCount)
+   {
+      SymTable_unlockAll(oSymTable);
+      return;
+   }
+
+   uNewCount = uSeenCount * 2;
+   psNewBuckets = SymTable_newBuckets(uNewCount);
+   if (psNewBuckets == NULL)
+   {
+      SymTable_unlockAll(oSymTable);
+      return;
+   }
+
+   for (u = 0; u < uSeenCount; u++)
+      for (psCurrentNode = psOldBuckets->psFirstNode[u];
+           psCurrentNode != NULL;
+           psCurrentNode = psNextNode)
+      {
+         psNextNode = psCurrentNode->psNextNode;
+         uIndex = psCurrentNode->uHash & (uNewCount - 1);
+         if (! oSymTable->iLockFreeReads)
+         {
+            psCurrentNode->psNextNode = psNewBuckets->psFirstNode[uIndex];
+            psNewBuckets->psFirstNode[uIndex] = psCurrentNode;
+            continue;
+         }
+
+         psCopy = SymTable_copyNode(psCurrentNode,
+            psNewBuckets->psFirstNode[uIndex]);
+         if (psCopy == NULL)
+         {
+            /* The old array is untouched; drop the copies */
+            SymTable_freeBuckets(psNewBuckets);
+            SymTable_unlockAll(oSymTable);
+            return;
+         }
+         psNewBuckets->psFirstNode[uIndex] = psCopy;
+      }
+
+   __atomic_store_n(&oSymTable->psBuckets, psNewBuckets,
+      __ATOMIC_RELEASE);
+   SymTable_unlockAll(oSymTable);
+
+   if (oSymTable->iLockFreeReads)
+      SymTableEpoch_retire(psOldBuckets, SymTable_freeBuckets);
+   else
+      free(psOldBuckets);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Create an empty table with uBucketCount buckets, a power of two at
+   least NUM_STRIPES. Return it, or NULL if insufficient memory is
+   available. */
+
+static SymTable_T SymTable_create(size_t uBucketCount)
+{
+   SymTable_T oSymTable;
+   size_t u;
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->psBuckets = SymTable_newBuckets(uBucketCount);
+   if (oSymTable->psBuckets == NULL)
+   {
+      free(oSymTable);
+      return NULL;
+   }
+   oSymTable->iLockFreeReads = 0;
+
+   for (u = 0; u < NUM_STRIPES; u++)
+   {
+      if (pthread_rwlock_init(&oSymTable->asStripes[u].sLock, NULL) != 0)
+      {
+         while (u > 0)
+            pthread_rwlock_destroy(&oSymTable->asStripes[--u].sLock);
+         free(oSymTable->psBuckets);
+         free(oSymTable);
+         return NULL;
+      }
+      oSymTable->asStripes[u].numBindings = 0;
+   }
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+   return SymTable_create(INITIAL_BUCKET_COUNT);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uExpected)
+{
+   size_t uCount;
+
+   /* Each stripe grows on its own share of the load, so leave room
+      for the expected bindings to spread unevenly over the stripes */
+   uCount = INITIAL_BUCKET_COUNT;
+   while (uExpected > uCount / 2 * MAX_LOAD_FACTOR)
+   {
+      /* No bucket array that large could be allocated */
+      if (uCount > (size_t)-1 / 2 / sizeof(struct SymTableNode*))
+         return NULL;
+      uCount *= 2;
+   }
+   return SymTable_create(uCount);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newConcurrent(void)
+{
+   return SymTable_new();
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newReadMostly(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      return NULL;
+   oSymTable->iLockFreeReads = 1;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   SymTable_freeBuckets(oSymTable->psBuckets);
+   for (u = 0; u < NUM_STRIPES; u++)
+      pthread_rwlock_destroy(&oSymTable->asStripes[u].sLock);
+   free(oSymTable);
+}
+
+/*---------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+   struct SymTableStripe *psStripe;
+   size_t uLength = 0;
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   for (u = 0; u < NUM_STRIPES; u++)
+   {
+      psStripe = &oSymTable->asStripes[u];
+      pthread_rwlock_rdlock(&psStripe->sLock);
+      uLength += psStripe->numBindings;
+      pthread_rwlock_unlock(&psStripe->sLock);
+   }
+   return uLength;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableStripe *psStripe;
+   struct SymTableBuckets *psBuckets;
+   struct SymTableNode *psNewNode;
+   size_t uIndex;
+   size_t uKeyLength;
+   size_t uHash;
+   size_t uSeenCount;
+   int iGrow;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyLength = strlen(pcKey);
+   uHash = SymTable_hashFast(pcKey, uKeyLength);
+
+   /* Build the node before taking the lock, to keep malloc out of the
+      critical section */
+   psNewNode = (struct SymTableNode*)malloc(
+      offsetof(struct SymTableNode, acKey) + uKeyLength + 1);
+   if (psNewNode == NULL)
+      return 0;
+   memcpy(psNewNode->acKey, pcKey, uKeyLength + 1);
+   psNewNode->pvValue = pvValue;
+   psNewNode->uHash = uHash;
+   psNewNode->uKeyLength = uKeyLength;
+
+   psStripe = SymTable_stripeOf(oSymTable, uHash);
+   pthread_rwlock_wrlock(&psStripe->sLock);
+
+   /*Searching for duplicate key*/
+   if (SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength) != NULL)
+   {
+      pthread_rwlock_unlock(&psStripe->sLock);
+      free(psNewNode);
+      return 0;
+   }
+
+   /* The node is complete before the release store makes it visible
+      to lock-free readers */
+   psBuckets = oSymTable->psBuckets;
+   uIndex = uHash & (psBuckets->numOfLinkedlists - 1);
+   psNewNode->psNextNode = psBuckets->psFirstNode[uIndex];
+   __atomic_store_n(&psBuckets->psFirstNode[uIndex], psNewNode,
+      __ATOMIC_RELEASE);
+   psStripe->numBindings++;
+
+   /* Each stripe judges the load from its own share of the buckets, so
+      no shared counter is needed */
+   uSeenCount = psBuckets->numOfLinkedlists;
+   iGrow = psStripe->numBindings >
+      uSeenCount / NUM_STRIPES * MAX_LOAD_FACTOR;
+   pthread_rwlock_unlock(&psStripe->sLock);
+
+   if (iGrow)
+      SymTable_grow(oSymTable, uSeenCount);
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableStripe *psStripe;
+   struct SymTableNode **ppsLink;
+   const void *oldValue = NULL;
+   size_t uKeyLength;
+   size_t uHash;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyLength = strlen(pcKey);
+   uHash = SymTable_hashFast(pcKey, uKeyLength);
+   psStripe = SymTable_stripeOf(oSymTable, uHash);
+
+   pthread_rwlock_wrlock(&psStripe->sLock);
+   ppsLink = SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength);
+   if (ppsLink != NULL)
+   {
+      oldValue = (*ppsLink)->pvValue;
+      __atomic_store_n(&(*ppsLink)->pvValue, pvValue, __ATOMIC_RELEASE);
+   }
+   pthread_rwlock_unlock(&psStripe->sLock);
+   return (void*)oldValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableEpochReader *psReader;
+   struct SymTableStripe *psStripe;
+   size_t uKeyLength;
+   size_t uHash;
+   int iFound;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyLength = strlen(pcKey);
+   uHash = SymTable_hashFast(pcKey, uKeyLength);
+
+   if (oSymTable->iLockFreeReads)
+   {
+      psReader = SymTableEpoch_enter();
+      if (psReader != NULL)
+      {
+         iFound = SymTable_findLockFree(oSymTable, pcKey, uHash,
+            uKeyLength) != NULL;
+         SymTableEpoch_exit(psReader);
+         return iFound;
+      }
+   }
+
+   psStripe = SymTable_stripeOf(oSymTable, uHash);
+   pthread_rwlock_rdlock(&psStripe->sLock);
+   iFound = SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength)
+      != NULL;
+   pthread_rwlock_unlock(&psStripe->sLock);
+   return iFound;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableEpochReader *psReader;
+   struct SymTableStripe *psStripe;
+   struct SymTableNode **ppsLink;
+   struct SymTableNode *psNode;
+   const void *value = NULL;
+   size_t uKeyLength;
+   size_t uHash;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyLength = strlen(pcKey);
+   uHash = SymTable_hashFast(pcKey, uKeyLength);
+
+   if (oSymTable->iLockFreeReads)
+   {
+      psReader = SymTableEpoch_enter();
+      if (psReader != NULL)
+      {
+         psNode = SymTable_findLockFree(oSymTable, pcKey, uHash,
+            uKeyLength);
+         if (psNode != NULL)
+            value = __atomic_load_n(&psNode->pvValue, __ATOMIC_ACQUIRE);
+         SymTableEpoch_exit(psReader);
+         return (void*)value;
+      }
+   }
+
+   psStripe = SymTable_stripeOf(oSymTable, uHash);
+   pthread_rwlock_rdlock(&psStripe->sLock);
+   ppsLink = SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength);
+   if (ppsLink != NULL)
+      value = (*ppsLink)->pvValue;
+   pthread_rwlock_unlock(&psStripe->sLock);
+   return (void*)value;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableStripe *psStripe;
+   struct SymTableNode **ppsLink;
+   struct SymTableNode *psCurrentNode = NULL;
+   const void *value = NULL;
+   size_t uKeyLength;
+   size_t uHash;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyLength = strlen(pcKey);
+   uHash = SymTable_hashFast(pcKey, uKeyLength);
+   psStripe = SymTable_stripeOf(oSymTable, uHash);
+
+   pthread_rwlock_wrlock(&psStripe->sLock);
+   ppsLink = SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength);
+   if (ppsLink != NULL)
+   {
+      psCurrentNode = *ppsLink;
+      value = psCurrentNode->pvValue;
+      /* The removed node keeps its link, so a lock-free reader standing
+         on it can carry on along the chain */
+      __atomic_store_n(ppsLink, psCurrentNode->psNextNode,
+         __ATOMIC_RELEASE);
+      psStripe->numBindings--;
+   }
+   pthread_rwlock_unlock(&psStripe->sLock);
+
+   if (psCurrentNode != NULL)
+   {
+      if (oSymTable->iLockFreeReads)
+         SymTableEpoch_retire(psCurrentNode, free);
+      else
+         free(psCurrentNode);
+   }
+   return (void*)value;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   struct SymTableBuckets *psBuckets;
+   struct SymTableNode *psCurrentNode;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   /* Readers may carry on, but no binding can change underneath */
+   SymTable_lockAll(oSymTable, 0);
+   psBuckets = oSymTable->psBuckets;
+   for (u = 0; u < psBuckets->numOfLinkedlists; u++)
+      for (psCurrentNode = psBuckets->psFirstNode[u];
+           psCurrentNode != NULL;
+           psCurrentNode = psCurrentNode->psNextNode)
+         (*pfApply)(psCurrentNode->acKey, (void*)psCurrentNode->pvValue,
+            (void*)pvExtra);
+   SymTable_unlockAll(oSymTable);
+}
@@ -0,0 +1,310 @@
+/*--------------------------------------------------------------------*/
+/* symtableepoch.c                                                    */
+/* Author: Ndongo Njie                                                */
+/* This file, symtableepoch.c, implements the process-wide epoch      */
+/* based reclamation used by the lock-free read path of the           */
+/* concurrent symbol table.                                           */
+/*--------------------------------------------------------------------*/
+
+/* pthreads and sched_yield are POSIX.1-2001 features */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "symtableepoch.h"
+
+/*--------------------------------------------------------------------*/
+
+/* A reclamation pass is tried once this many blocks are waiting */
+enum {RECLAIM_THRESHOLD = 64};
+
+/* The number of limbo lists: blocks retired in epoch e wait in list
+   e % NUM_LIMBO_LISTS until the epoch reaches e + 2. */
+enum {NUM_LIMBO_LISTS = 3};
+
+/*--------------------------------------------------------------------*/
+
+/* Each thread that has ever read owns a SymTableEpochReader. Readers
+   are linked to form a list that only ever grows; the record of a
+   thread that has exited is reused by the next new thread. */
+
+struct SymTableEpochReader
+{
+   /* 0 outside a read section; otherwise the epoch at which the
+      section began, shifted left once, with the low bit set */
+   size_t uState;
+
+   /* 1 (TRUE) if a live thread owns the record */
+   int iInUse;
+
+   /* The address of the next reader */
+   struct SymTableEpochReader *psNextReader;
+
+   /* Keeps each thread's record off other threads' cache lines, since
+      the record is written on every read */
+   char acPad[64];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableEpochRetired is a block waiting to be freed. */
+
+struct SymTableEpochRetired
+{
+   /* The block */
+   void *pvBlock;
+
+   /* The function that frees it */
+   void (*pfFree)(void *pvBlock);
+
+   /* The address of the next retired block of the same epoch */
+   struct SymTableEpochRetired *psNextRetired;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* The current epoch. Advanced only while holding sLimboLock. */
+static size_t uGlobalEpoch = 0;
+
+/* The first reader record */
+static struct SymTableEpochReader *psFirstReader = NULL;
+
+/* Guards the limbo lists, uLimboCount and epoch advancement */
+static pthread_mutex_t sLimboLock = PTHREAD_MUTEX_INITIALIZER;
+
+/* The retired blocks, by epoch */
+static struct SymTableEpochRetired *apsLimbo[NUM_LIMBO_LISTS];
+
+/* The number of blocks in the limbo lists */
+static size_t uLimboCount = 0;
+
+/* The key under which each thread keeps its reader record */
+static pthread_key_t sReaderKey;
+
+/* 1 (TRUE) once sReaderKey has been created */
+static int iReaderKeyCreated = 0;
+
+/* Ensures that sReaderKey is created once */
+static pthread_once_t sReaderKeyOnce = PTHREAD_ONCE_INIT;
+
+/*--------------------------------------------------------------------*/
+
+/* Give back the reader record pvReader when the thread that owns it
+   exits. */
+
+static void SymTableEpoch_releaseReader(void *pvReader)
+{
+   struct SymTableEpochReader *psReader;
+
+   assert(pvReader != NULL);
+
+   psReader = (struct SymTableEpochReader*)pvReader;
+   __atomic_store_n(&psReader->uState, 0, __ATOMIC_RELEASE);
+   __atomic_store_n(&psReader->iInUse, 0, __ATOMIC_RELEASE);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Create sReaderKey. */
+
+static void SymTableEpoch_createKey(void)
+{
+   iReaderKeyCreated = pthread_key_create(&sReaderKey,
+      SymTableEpoch_releaseReader) == 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return a reader record for the calling thread: a free one if there
+   is one, and otherwise a new one. Return NULL if insufficient memory
+   is available. */
+
+static struct SymTableEpochReader *SymTableEpoch_claimReader(void)
+{
+   struct SymTableEpochReader *psReader;
+   int iFree;
+
+   for (psReader = __atomic_load_n(&psFirstReader, __ATOMIC_ACQUIRE);
+        psReader != NULL;
+        psReader = psReader->psNextReader)
+   {
+      iFree = 0;
+      if (__atomic_compare_exchange_n(&psReader->iInUse, &iFree, 1, 0,
+             __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+         return psReader;
+   }
+
+   psReader = (struct SymTableEpochReader*)
+      malloc(sizeof(struct SymTableEpochReader));
+   if (psReader == NULL)
+      return NULL;
+   psReader->uState = 0;
+   psReader->iInUse = 1;
+   psReader->psNextReader = __atomic_load_n(&psFirstReader,
+      __ATOMIC_RELAXED);
+   while (! __atomic_compare_exchange_n(&psFirstReader,
+             &psReader->psNextReader, psReader, 1,
+             __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+      ;
+   return psReader;
+}
+
+/*--------------------------------------------------------------------*/
+
+struct SymTableEpochReader *SymTableEpoch_enter(void)
+{
+   struct SymTableEpochReader *psReader;
+   size_t uEpoch;
+
+   pthread_once(&sReaderKeyOnce, SymTableEpoch_createKey);
+   if (! iReaderKeyCreated)
+      return NULL;
+
+   psReader = (struct SymTableEpochReader*)
+      pthread_getspecific(sReaderKey);
+   if (psReader == NULL)
+   {
+      psReader = SymTableEpoch_claimReader();
+      if (psReader == NULL)
+         return NULL;
+      if (pthread_setspecific(sReaderKey, psReader) != 0)
+      {
+         SymTableEpoch_releaseReader(psReader);
+         return NULL;
+      }
+   }
+
+   assert(psReader->uState == 0);
+
+   /* The announcement must be visible before any shared pointer is
+      read, or a reclaimer could miss this reader */
+   uEpoch = __atomic_load_n(&uGlobalEpoch, __ATOMIC_ACQUIRE);
+   __atomic_store_n(&psReader->uState, (uEpoch << 1) | 1,
+      __ATOMIC_SEQ_CST);
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   return psReader;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTableEpoch_exit(struct SymTableEpochReader *psReader)
+{
+   assert(psReader != NULL);
+   assert(psReader->uState != 0);
+
+   __atomic_store_n(&psReader->uState, 0, __ATOMIC_RELEASE);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free every block of the limbo list *ppsList and empty it. The caller
+   must hold sLimboLock. */
+
+static void SymTableEpoch_freeList(struct SymTableEpochRetired **ppsList)
+{
+   struct SymTableEpochRetired *psRetired;
+   struct SymTableEpochRetired *psNextRetired;
+
+   assert(ppsList != NULL);
+
+   for (psRetired = *ppsList; psRetired != NULL;
+        psRetired = psNextRetired)
+   {
+      psNextRetired = psRetired->psNextRetired;
+      (*psRetired->pfFree)(psRetired->pvBlock);
+      free(psRetired);
+      uLimboCount--;
+   }
+   *ppsList = NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Advance the epoch if every thread in a read section began it in the
+   current epoch, freeing the blocks that then become unreachable.
+   The caller must hold sLimboLock. */
+
+static void SymTableEpoch_tryAdvance(void)
+{
+   struct SymTableEpochReader *psReader;
+   size_t uEpoch;
+   size_t uState;
+
+   uEpoch = __atomic_load_n(&uGlobalEpoch, __ATOMIC_RELAXED);
+
+   /* Pairs with the fence in SymTableEpoch_enter: the unlinking of
+      the retired blocks is ordered before the readers are checked */
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   for (psReader = __atomic_load_n(&psFirstReader, __ATOMIC_ACQUIRE);
+        psReader != NULL;
+        psReader = psReader->psNextReader)
+   {
+      uState = __atomic_load_n(&psReader->uState, __ATOMIC_ACQUIRE);
+      if ((uState & 1) != 0 && (uState >> 1) != uEpoch)
+         return;
+   }
+
+   /* Every reader now began in uEpoch, so none can still see a block
+      retired in uEpoch - 1 */
+   SymTableEpoch_freeList(&apsLimbo[(uEpoch + NUM_LIMBO_LISTS - 1)
+      % NUM_LIMBO_LISTS]);
+   __atomic_store_n(&uGlobalEpoch, uEpoch + 1, __ATOMIC_RELEASE);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Wait until every read section in progress at the time of the call
+   has ended. */
+
+static void SymTableEpoch_synchronize(void)
+{
+   struct SymTableEpochReader *psReader;
+   size_t uState;
+
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   for (psReader = __atomic_load_n(&psFirstReader, __ATOMIC_ACQUIRE);
+        psReader != NULL;
+        psReader = psReader->psNextReader)
+   {
+      uState = __atomic_load_n(&psReader->uState, __ATOMIC_ACQUIRE);
+      if ((uState & 1) == 0)
+         continue;
+      while (__atomic_load_n(&psReader->uState, __ATOMIC_ACQUIRE)
+             == uState)
+         sched_yield();
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTableEpoch_retire(void *pvBlock, void (*pfFree)(void *pvBlock))
+{
+   struct SymTableEpochRetired *psRetired;
+   size_t uEpoch;
+
+   assert(pvBlock != NULL);
+   assert(pfFree != NULL);
+
+   psRetired = (struct SymTableEpochRetired*)
+      malloc(sizeof(struct SymTableEpochRetired));
+   if (psRetired == NULL)
+   {
+      /* No room to queue the block: wait out the readers instead */
+      SymTableEpoch_synchronize();
+      (*pfFree)(pvBlock);
+      return;
+   }
+   psRetired->pvBlock = pvBlock;
+   psRetired->pfFree = pfFree;
+
+   pthread_mutex_lock(&sLimboLock);
+   uEpoch = __atomic_load_n(&uGlobalEpoch, __ATOMIC_RELAXED);
+   psRetired->psNextRetired = apsLimbo[uEpoch % NUM_LIMBO_LISTS];
+   apsLimbo[uEpoch % NUM_LIMBO_LISTS] = psRetired;
+   uLimboCount++;
+   if (uLimboCount >= RECLAIM_THRESHOLD)
+      SymTableEpoch_tryAdvance();
+   pthread_mutex_unlock(&sLimboLock);
+}
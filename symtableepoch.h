@@ -0,0 +1,46 @@
+/*--------------------------------------------------------------------*/
+/* symtableepoch.h                                                    */
+/* Author: Ndongo Njie                                                */
+/* This file, symtableepoch.h, defines the functions used to free     */
+/* memory that lock-free readers may still be looking at, once no     */
+/* reader can be.                                                     */
+/*--------------------------------------------------------------------*/
+
+#ifndef SymTableEpoch_INCLUDED
+#define SymTableEpoch_INCLUDED
+#include <stddef.h>
+
+/* A SymTableEpochReader records whether one thread is inside a read
+   section, and since which epoch. Each thread gets its own the first
+   time it enters a read section. */
+
+struct SymTableEpochReader;
+
+/*--------------------------------------------------------------------*/
+
+/* Begin a read section on the calling thread and return the thread's
+   reader record, to be passed to SymTableEpoch_exit. Memory retired
+   after the section begins is not freed until it ends. Return NULL if
+   insufficient memory is available for the record, in which case the
+   caller must not rely on the epoch protecting it. Read sections must
+   not nest. */
+
+struct SymTableEpochReader *SymTableEpoch_enter(void);
+
+/*--------------------------------------------------------------------*/
+
+/* End the read section of psReader, which SymTableEpoch_enter
+   returned. */
+
+void SymTableEpoch_exit(struct SymTableEpochReader *psReader);
+
+/*--------------------------------------------------------------------*/
+
+/* Call (*pfFree)(pvBlock) once every read section that was in progress
+   when pvBlock was retired has ended. pvBlock must already be
+   unreachable by readers that start from now on. Must not be called
+   from inside a read section. */
+
+void SymTableEpoch_retire(void *pvBlock, void (*pfFree)(void *pvBlock));
+
+#endif
@@ -7,27 +7,66 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "symtable.h"
+#include "symtablearena.h"
+#include "symtableintern.h"
+#include "symtablepool.h"
+#include "symtableimage.h"
+#include <stdio.h>
 #include <string.h>
 
 /*---------------------------------------------------------------------*/
 
-/*The sizes of the expanding hash table */
+/*The sizes of the expanding hash table. Past 65521, each size is the 
+smallest prime above twice the previous size. The list ends at the last
+such prime that fits in 32 bits, a bucket array of 32 GiB with 8-byte 
+pointers; a table that large keeps its size and takes on more load. */
 static const size_t auBucketCounts[] = {509, 1021, 2039, 4093, 8191, 
-16381, 32749, 65521};
+16381, 32749, 65521, 131059, 262121, 524243, 1048507, 2097023, 4194103,
+8388209, 16776451, 33552923, 67105849, 134211703, 268423423, 536846861,
+1073693729, 2147387503, 4294775033U};
 
 /* Calculate the number of bucket counts */
 static const size_t numBucketCounts = (sizeof(auBucketCounts)) / 
 (sizeof(auBucketCounts[0]));
 
+/* A new table keeps its bindings in a single chain held in the table
+   itself, searched from end to end, and only gets a bucket array of
+   auBucketCounts[0] buckets when a put would take it past this many */
+enum {SMALL_TABLE_CAPACITY = 8};
+
+/* The maximum load factor of a table made by SymTable_new */
+static const double DEFAULT_MAX_LOAD_FACTOR = 1.0;
+
+/* The number of old buckets an incremental resize moves per call */
+static const size_t MIGRATE_BUCKETS_PER_CALL = 4;
+
+/* Tables with fewer bindings than this rehash on one thread even if 
+   they were made by SymTable_newParallelResize, because starting the 
+   threads would cost more than it saves */
+static const size_t PARALLEL_RESIZE_MIN_BINDINGS = 100000;
+
+/* The number of keys SymTable_getMany has in flight at once: enough 
+   outstanding prefetches to cover a memory miss, few enough that the 
+   prefetched lines are still cached when they are used */
+enum {GET_MANY_GROUP = 16};
+
+/* Every entry and value in a frozen image starts at a multiple of this
+   many bytes, enough for any value the caller may store there */
+enum {IMAGE_ALIGN = 16};
+
+/* The first bytes of every frozen image */
+static const char acImageMagic[8] = "SYMTAB1";
+
 
 /*---------------------------------------------------------------------*/
 
 /* Each item is stored in a SymTableNode.  SymTableNodes are linked to
-   form a list.  */
+   form a list. A node and its copy of the key are a single allocation;
+   a node for an interned key points at the interned string instead.  */
 
 struct SymTableNode
 {
-   /* The key */
+   /* The key: acKey, or a string returned by SymTable_intern */
    const char *pcKey;
 
     /* The value*/
@@ -35,6 +74,18 @@ struct SymTableNode
 
    /* The address of the next SymTableNode. */
    struct SymTableNode *psNextNode;
+
+   /* The full hash code of the key, before reduction to a bucket
+      index. Resizing reuses it, and chain walks compare it before
+      looking at the key itself. */
+   size_t uHash;
+
+   /* The length of the key */
+   size_t uKeyLength;
+
+   /* The copy of the key, stored inline right after the fields above;
+      empty for an interned key */
+   char acKey[];
 };
 
 
@@ -51,305 +102,1735 @@ struct SymTable
    size_t numBindings;
    /*Number of linked lists in the hash table */
    size_t numOfLinkedlists;
+   /* The table grows once numBindings exceeds this many bindings per
+      linked list */
+   double dMaxLoadFactor;
+
+   /* While a resize is in progress, the bucket array being drained
+      into psFirstNode; NULL otherwise. */
+   struct SymTableNode **psOldFirstNode;
+   /* Number of linked lists in psOldFirstNode */
+   size_t numOfOldLinkedlists;
+   /* Every bucket of psOldFirstNode below this index is already empty */
+   size_t uMigrateIndex;
+
+   /* The only bucket of a table that has never held more than
+      SMALL_TABLE_CAPACITY bindings, so that a small table costs no
+      bucket array. psFirstNode points here until the table grows. */
+   struct SymTableNode *psSmallBucket;
+
+   /* The table never shrinks below this many buckets on its own:
+      auBucketCounts[0], or more once SymTable_reserve has sized it for
+      an expected number of bindings */
+   size_t uMinLinkedlists;
+
+   /* 1 (TRUE) if a resize is spread over later calls, 0 (FALSE) if it
+      moves every node at once */
+   int iIncremental;
+
+   /* The number of threads that share a resize that moves every node
+      at once */
+   size_t uResizeThreads;
+
+   /* The number of cursors between SymTable_iterBegin and
+      SymTable_iterEnd. The table does not shrink while there are any,
+      since a shrink would relink the bindings behind their backs. */
+   size_t uOpenIters;
+
+   /* The arena that nodes are carved from, or NULL if each node is
+      allocated with malloc */
+   SymTableArena_T oArena;
+
+   /* The caller's hash function, or NULL for the built-in
+      SymTable_hashFast */
+   size_t (*pfHash)(const char *pcKey, size_t uLength);
+
+   /* The caller's key equality function, or NULL to compare bytes */
+   int (*pfEqual)(const char *pcKey1, const char *pcKey2,
+      size_t uLength);
+
+   /* The mapped image of a table made by SymTable_openFrozen, which
+      answers every lookup, or NULL for an ordinary table */
+   const unsigned char *pucImage;
+
+   /* The size of pucImage in bytes */
+   size_t uImageSize;
 };
 
 
 /*---------------------------------------------------------------------*/
 
-/* Return a hash code for pcKey that is between 0 and uBucketCount-1,
-   inclusive. */
+/* A frozen image, as written by SymTable_freeze, is a header, then an
+   index of numSlots SymTableImageSlots, then the entries. It holds no
+   pointers, only offsets from its first byte, so it can be mapped at
+   any address. */
+
+struct SymTableImageHeader
+{
+   /* acImageMagic */
+   char acMagic[8];
+
+   /* The size of this header, which also rejects an image written
+      with a different word size or byte order */
+   size_t uHeaderSize;
+
+   /* The number of bindings */
+   size_t numBindings;
+
+   /* The number of slots in the index, a power of two at least twice
+      numBindings, so that every probe ends at an empty slot */
+   size_t numSlots;
 
-static size_t SymTable_hash(const char *pcKey, size_t uBucketCount)
+   /* The size of the whole image in bytes */
+   size_t uImageSize;
+};
+
+/* A slot of the index is found by linear probing from the
+   SymTable_hashFast code of its key. */
+
+struct SymTableImageSlot
+{
+   /* The full hash code of the key */
+   size_t uHash;
+
+   /* The offset of the key's SymTableImageEntry, or 0 if the slot is
+      empty */
+   size_t uEntryOffset;
+};
+
+/* An entry holds a key and is followed by its value's bytes, so that
+   a hit usually touches one page past the index. */
+
+struct SymTableImageEntry
 {
-   const size_t HASH_MULTIPLIER = 65599;
-   size_t u;
-   size_t uHash = 0;
+   /* The length of the key */
+   size_t uKeyLength;
 
+   /* The offset of the value's bytes, or 0 for a NULL value */
+   size_t uValueOffset;
+
+   /* The key and its terminating null character */
+   char acKey[];
+};
+
+
+/*---------------------------------------------------------------------*/
+
+/* Return the full hash code under oSymTable's hash function of the key
+   made of the uKeyLength characters at pcKey. */
+
+static size_t SymTable_hash(SymTable_T oSymTable, const char *pcKey,
+   size_t uKeyLength)
+{
+   assert(oSymTable != NULL);
    assert(pcKey != NULL);
 
-   for (u = 0; pcKey[u] != '\0'; u++)
-      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+   if (oSymTable->pfHash == NULL)
+      return SymTable_hashFast(pcKey, uKeyLength);
+   return (*oSymTable->pfHash)(pcKey, uKeyLength);
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Ask the processor to start loading the cache line at pvAddress, 
+   where supported. */
 
-   return uHash % uBucketCount;
+static void SymTable_prefetch(const void *pvAddress)
+{
+#if defined(__GNUC__)
+   __builtin_prefetch(pvAddress);
+#else
+   (void)pvAddress;
+#endif
 }
 
 
 /*---------------------------------------------------------------------*/
 
-/* The resize function is responsible for expanding the hash table. It
-accepts a symbol table, "oSymTable", as an argument. It increases the 
-size of the hash table to the next index specified in "auBucketCounts", 
-and then transfers all existing elements from the previous hash table 
-to the newly expanded one. This function does not return any value. */
+/* Return the full hash code of sKey under oSymTable's hash function. 
+For the built-in hash that is the code sKey already holds. */
 
-static void SymTable_resizeIfNeeded(SymTable_T oSymTable) {
-    size_t newSize = auBucketCounts[oSymTable->numOfLinkedlists];
-    struct SymTableNode **newTable;
-    size_t i;
+static size_t SymTable_keyHash(SymTable_T oSymTable, SymTable_Key sKey)
+{
+   assert(oSymTable != NULL);
+   assert(sKey.pcKey != NULL);
+
+   if (oSymTable->pfHash == NULL)
+      return sKey.uHash;
+   return (*oSymTable->pfHash)(sKey.pcKey, sKey.uLength);
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Return the bucket, between 0 and uBucketCount-1 inclusive, of a key
+   whose full hash code is uHash in oSymTable. The built-in hash mixes
+   all of its bits, so its low 32 bits are scaled into range with a
+   multiply and a shift; a caller's hash may not, so it is reduced
+   modulo the (prime) bucket count instead. */
+
+static size_t SymTable_bucketOf(SymTable_T oSymTable, size_t uHash,
+   size_t uBucketCount)
+{
+   assert(oSymTable != NULL);
+
+   if (oSymTable->pfHash != NULL || uBucketCount > 0xFFFFFFFFUL)
+      return uHash % uBucketCount;
+   return (size_t)(((unsigned long long)(uHash & 0xFFFFFFFFUL) *
+      uBucketCount) >> 32);
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Return the bucket count that follows uCount: the next entry of
+auBucketCounts, or uCount itself once those run out. */
+
+static size_t SymTable_nextBucketCount(size_t uCount) {
+    size_t index;
+
+    for (index = 0; index < numBucketCounts; index++)
+        if (auBucketCounts[index] > uCount)
+            return auBucketCounts[index];
+    return uCount;
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Free ppsBuckets, a bucket array of oSymTable, unless it is the
+   table's own psSmallBucket. */
+
+static void SymTable_freeBuckets(SymTable_T oSymTable,
+     struct SymTableNode **ppsBuckets) {
+    assert(oSymTable != NULL);
+
+    if (ppsBuckets != &oSymTable->psSmallBucket)
+        free(ppsBuckets);
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Move up to uBuckets buckets of oSymTable's old bucket array into
+   the current one, oldest first. Once the old array is empty, free it
+   and end the resize. Does nothing if no resize is in progress. */
+
+static void SymTable_migrate(SymTable_T oSymTable, size_t uBuckets) {
+    struct SymTableNode *psCurrentNode;
+    struct SymTableNode *psNextNode;
     size_t newIndex;
 
-    newTable = calloc(newSize, sizeof(struct SymTableNode *));
+    assert(oSymTable != NULL);
+    /* Every call that may change a table passes through here first */
+    assert(oSymTable->pucImage == NULL);
 
-    assert(newTable != NULL);
+    if (oSymTable->psOldFirstNode == NULL)
+        return;
 
-    /* Transfer existing elements to the new table */
-    for (i = 0; i < oSymTable->numOfLinkedlists; i++) {
-        struct SymTableNode *psCurrentNode = oSymTable->psFirstNode[i];
+    while (uBuckets > 0 &&
+    oSymTable->uMigrateIndex < oSymTable->numOfOldLinkedlists) {
+        psCurrentNode =
+            oSymTable->psOldFirstNode[oSymTable->uMigrateIndex];
         while (psCurrentNode != NULL) {
-            struct SymTableNode *psNextNode = psCurrentNode->psNextNode;
-            newIndex = SymTable_hash(psCurrentNode->pcKey, newSize);
-            psCurrentNode->psNextNode = newTable[newIndex];
-            newTable[newIndex] = psCurrentNode;
+            psNextNode = psCurrentNode->psNextNode;
+            newIndex = SymTable_bucketOf(oSymTable, psCurrentNode->uHash,
+                oSymTable->numOfLinkedlists);
+            psCurrentNode->psNextNode = oSymTable->psFirstNode[newIndex];
+            oSymTable->psFirstNode[newIndex] = psCurrentNode;
             psCurrentNode = psNextNode;
         }
+        oSymTable->psOldFirstNode[oSymTable->uMigrateIndex] = NULL;
+        oSymTable->uMigrateIndex++;
+        uBuckets--;
     }
 
-    /* Free old hash table and update SymTable */
-    free(oSymTable->psFirstNode);
-    oSymTable->psFirstNode = newTable;
-    oSymTable->numOfLinkedlists = newSize;
+    if (oSymTable->uMigrateIndex == oSymTable->numOfOldLinkedlists) {
+        SymTable_freeBuckets(oSymTable, oSymTable->psOldFirstNode);
+        oSymTable->psOldFirstNode = NULL;
+        oSymTable->numOfOldLinkedlists = 0;
+        oSymTable->uMigrateIndex = 0;
+    }
 }
 
 
 /*---------------------------------------------------------------------*/
 
-SymTable_T SymTable_new(void)
-{
-   SymTable_T oSymTable;
-
-   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
-   if (oSymTable == NULL)
-      return NULL;
+/* Move every node in old buckets uBegin to uEnd-1 of the SymTable at
+pvSymTable into its current bucket array, as SymTable_migrate does, but
+without updating uMigrateIndex. Several threads may do this at once for
+disjoint ranges: each node is pushed onto the head of its new bucket 
+with a compare-and-swap, so two threads filling the same new bucket 
+cannot lose a node. The new chains hold the same nodes as after a 
+serial rehash, though possibly in a different order. */
+
+static void SymTable_rehashRange(void *pvSymTable, size_t uThread,
+     size_t uBegin, size_t uEnd) {
+    SymTable_T oSymTable;
+    struct SymTableNode *psCurrentNode;
+    struct SymTableNode *psNextNode;
+    struct SymTableNode **ppsHead;
+    size_t index;
 
-   oSymTable->psFirstNode = calloc(auBucketCounts[0], 
-   sizeof(struct SymTableNode*));
-   if (oSymTable->psFirstNode == NULL) {
-    free(oSymTable);
-    return NULL;
-   }
+    assert(pvSymTable != NULL);
+    (void)uThread;
 
-   oSymTable->numBindings = 0;
-   oSymTable->numOfLinkedlists = auBucketCounts[0];
-   return oSymTable;
+    oSymTable = (SymTable_T)pvSymTable;
+    for (index = uBegin; index < uEnd; index++) {
+        psCurrentNode = oSymTable->psOldFirstNode[index];
+        while (psCurrentNode != NULL) {
+            psNextNode = psCurrentNode->psNextNode;
+            ppsHead = &oSymTable->psFirstNode[SymTable_bucketOf(oSymTable,
+                psCurrentNode->uHash, oSymTable->numOfLinkedlists)];
+            psCurrentNode->psNextNode =
+                __atomic_load_n(ppsHead, __ATOMIC_RELAXED);
+            while (! __atomic_compare_exchange_n(ppsHead,
+                &psCurrentNode->psNextNode, psCurrentNode, 1,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                ;
+            psCurrentNode = psNextNode;
+        }
+        oSymTable->psOldFirstNode[index] = NULL;
+    }
 }
 
+
 /*---------------------------------------------------------------------*/
 
-void SymTable_free(SymTable_T oSymTable)
-{
-   struct SymTableNode *psCurrentNode;
-   struct SymTableNode *psNextNode;
-   size_t index;
+/* Return the smallest bucket count in the sequence produced by 
+SymTable_nextBucketCount, starting from auBucketCounts[0], that keeps 
+uBindings bindings at or below dLoadFactor bindings per bucket. */
+
+static size_t SymTable_bucketCountFor(size_t uBindings,
+     double dLoadFactor) {
+    size_t uCount;
+    size_t uNext;
+
+    uCount = auBucketCounts[0];
+    while ((double)uBindings > dLoadFactor * (double)uCount) {
+        uNext = SymTable_nextBucketCount(uCount);
+        if (uNext == uCount)
+            break;
+        uCount = uNext;
+    }
+    return uCount;
+}
 
-   assert(oSymTable != NULL);
 
-    for (index = 0; index < oSymTable->numOfLinkedlists; index++) 
-        for (psCurrentNode = oSymTable->psFirstNode[index];
-        psCurrentNode != NULL;
-        psCurrentNode = psNextNode)
-   {
-      psNextNode = psCurrentNode->psNextNode;
-      /* Free where the key points to before freeing the main node */
-      free((char*)psCurrentNode->pcKey); 
-      free(psCurrentNode);
-   }
-    free(oSymTable->psFirstNode);
-    free(oSymTable);
-}
+/*---------------------------------------------------------------------*/
 
+/* Start moving oSymTable into a new bucket array of newSize buckets,
+finishing any resize already in progress first. The nodes are moved all 
+at once, spread over oSymTable->uResizeThreads threads for a large 
+table, or, for an incremental table, a few buckets per later call. If 
+memory is short the table simply keeps its current size. */
 
-/*--------------------------------------------------------------------*/
+static void SymTable_resizeTo(SymTable_T oSymTable, size_t newSize) {
+    struct SymTableNode **newTable;
 
-size_t SymTable_getLength(SymTable_T oSymTable)
-{
     assert(oSymTable != NULL);
-    return oSymTable->numBindings;
+
+    /* A previous resize must be finished before another can start */
+    SymTable_migrate(oSymTable, oSymTable->numOfOldLinkedlists);
+
+    newTable = calloc(newSize, sizeof(struct SymTableNode *));
+    if (newTable == NULL)
+        return;
+
+    oSymTable->psOldFirstNode = oSymTable->psFirstNode;
+    oSymTable->numOfOldLinkedlists = oSymTable->numOfLinkedlists;
+    oSymTable->uMigrateIndex = 0;
+    oSymTable->psFirstNode = newTable;
+    oSymTable->numOfLinkedlists = newSize;
+
+    if (oSymTable->iIncremental)
+        return;
+
+    /* Joining the pool's threads orders their stores before the final
+    migrate, which then only finds empty buckets and frees the array */
+    if (oSymTable->uResizeThreads > 1 &&
+        oSymTable->numBindings >= PARALLEL_RESIZE_MIN_BINDINGS)
+        SymTablePool_run(oSymTable->numOfOldLinkedlists,
+            oSymTable->uResizeThreads, SymTable_rehashRange, oSymTable);
+    SymTable_migrate(oSymTable, oSymTable->numOfOldLinkedlists);
 }
 
 
-/*--------------------------------------------------------------------*/
+/*---------------------------------------------------------------------*/
 
-int SymTable_put(SymTable_T oSymTable,
-     const char *pcKey, const void *pvValue) {
-    struct SymTableNode *psCurrentNode;
-    struct SymTableNode *psNewNode;
-    size_t hashIndex;
+/* The resize function is responsible for expanding the hash table. It
+accepts a symbol table, "oSymTable", as an argument, and is called
+before each binding is added. Once oSymTable holds more than its
+maximum load factor of bindings per bucket, it moves to the next size
+given by SymTable_nextBucketCount. A table still using its
+psSmallBucket instead moves to a bucket array once it already holds
+SMALL_TABLE_CAPACITY bindings, so that the chain never gets longer.
+This function does not return any value. */
+
+static void SymTable_resizeIfNeeded(SymTable_T oSymTable) {
+    size_t newSize;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
 
-    hashIndex = SymTable_hash(pcKey, oSymTable->numOfLinkedlists);
-    
-    /* Making sure we resize only when necessary */
-    if (oSymTable != NULL &&
-    oSymTable->numBindings > 0 &&
-    oSymTable->numOfLinkedlists > 0 &&
-    oSymTable->numOfLinkedlists < numBucketCounts &&
-    oSymTable->numBindings > auBucketCounts[oSymTable->
-    numOfLinkedlists - 1]) {
-        SymTable_resizeIfNeeded(oSymTable);
+    if (oSymTable->psFirstNode == &oSymTable->psSmallBucket) {
+        if (oSymTable->numBindings >= SMALL_TABLE_CAPACITY)
+            SymTable_resizeTo(oSymTable, SymTable_bucketCountFor(
+                oSymTable->numBindings + 1, oSymTable->dMaxLoadFactor));
+        return;
     }
 
-    /*Searching for duplicate key*/
-    for (psCurrentNode = oSymTable->psFirstNode[hashIndex];
-        psCurrentNode != NULL;
-        psCurrentNode =psCurrentNode->psNextNode)
-    {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) return 0;
+    if ((double)oSymTable->numBindings >
+        oSymTable->dMaxLoadFactor * (double)oSymTable->numOfLinkedlists) {
+        newSize = SymTable_nextBucketCount(oSymTable->numOfLinkedlists);
+        if (newSize != oSymTable->numOfLinkedlists)
+            SymTable_resizeTo(oSymTable, newSize);
     }
-    /*It is not a duplicate, make space for the new node and key copy*/
-    psNewNode = (struct SymTableNode*)malloc(sizeof(struct SymTableNode));
-    if (psNewNode == NULL)
-      return 0;
+}
 
-    psNewNode->pcKey = malloc(strlen(pcKey)+1);
-    if (psNewNode->pcKey == NULL) {
-        free(psNewNode);
-        return 0;
-    }
 
-    /*We have a space and should copy the key and value and insert the
-    new node*/
-    psNewNode->pcKey = strcpy((char*)psNewNode->pcKey, pcKey);
-    psNewNode->pvValue = pvValue;
+/*---------------------------------------------------------------------*/
 
-    psNewNode->psNextNode = oSymTable->psFirstNode[hashIndex];
-    oSymTable->psFirstNode[hashIndex] = psNewNode;
-    oSymTable->numBindings++;
-    return 1; /*Successfully inserted a new node*/
+/* The shrink function gives memory back once oSymTable is mostly
+empty, and is called after each binding is removed. Once oSymTable
+holds fewer than a quarter of its maximum load factor of bindings per
+bucket, it moves to the smallest size that leaves it at no more than
+half of its maximum load factor, so that a table never shrinks and
+grows back within a few calls. It never shrinks below the size
+SymTable_reserve gave it, nor while a cursor is open. */
+
+static void SymTable_shrinkIfNeeded(SymTable_T oSymTable) {
+    size_t newSize;
+
+    assert(oSymTable != NULL);
+
+    if (oSymTable->psFirstNode == &oSymTable->psSmallBucket ||
+        oSymTable->numOfLinkedlists <= oSymTable->uMinLinkedlists ||
+        oSymTable->uOpenIters > 0)
+        return;
+
+    if ((double)oSymTable->numBindings <
+        oSymTable->dMaxLoadFactor * (double)oSymTable->numOfLinkedlists
+        / 4) {
+        newSize = SymTable_bucketCountFor(oSymTable->numBindings,
+            oSymTable->dMaxLoadFactor / 2);
+        if (newSize < oSymTable->uMinLinkedlists)
+            newSize = oSymTable->uMinLinkedlists;
+        if (newSize < oSymTable->numOfLinkedlists)
+            SymTable_resizeTo(oSymTable, newSize);
+    }
 }
 
 
 /*---------------------------------------------------------------------*/
 
-/*Similar to get but saves the old value, replaces it and returns the
-old value*/
-void *SymTable_replace(SymTable_T oSymTable,
-     const char *pcKey, const void *pvValue) { 
-    struct SymTableNode *psCurrentNode;
-    const void *oldValue;
-    size_t hashIndex;
-
+/* Return 1 (TRUE) if psNode, a node of oSymTable, holds key pcKey, 
+whose hash code is uHash and whose length is uKeyLength, and 0 (FALSE) 
+otherwise. The keys are only compared once the cached hash and length 
+agree, and identical pointers (an interned key) then match at once. */
 
+static int SymTable_nodeMatches(SymTable_T oSymTable,
+     const struct SymTableNode *psNode, const char *pcKey, size_t uHash,
+     size_t uKeyLength) {
     assert(oSymTable != NULL);
+    assert(psNode != NULL);
     assert(pcKey != NULL);
 
-    hashIndex = SymTable_hash(pcKey, oSymTable->numOfLinkedlists);
+    if (psNode->uHash != uHash || psNode->uKeyLength != uKeyLength)
+        return 0;
+    if (psNode->pcKey == pcKey)
+        return 1;
+    if (oSymTable->pfEqual != NULL)
+        return (*oSymTable->pfEqual)(pcKey, psNode->pcKey, uKeyLength);
+    return memcmp(pcKey, psNode->pcKey, uKeyLength) == 0;
+}
 
-    for (psCurrentNode = oSymTable->psFirstNode[hashIndex];
-        psCurrentNode != NULL;
-        psCurrentNode =psCurrentNode->psNextNode)
-    {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) {
-            oldValue = psCurrentNode-> pvValue;
-            psCurrentNode->pvValue = pvValue;
-            return (void*)oldValue;
-        }
-    }
-    return NULL; /*Does not find the pcKey */
-}  
 
+/*---------------------------------------------------------------------*/
 
-/*--------------------------------------------------------------------*/
+/* Return the address of the link (a bucket head or a psNextNode field)
+that points to the node of oSymTable whose key is pcKey, or NULL if 
+there is no such node. uHash and uKeyLength are the hash code and 
+length of pcKey. Both bucket arrays are searched while a resize is in 
+progress. */
 
-int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
-    struct SymTableNode *psCurrentNode;
+static struct SymTableNode **SymTable_findLink(SymTable_T oSymTable,
+     const char *pcKey, size_t uHash, size_t uKeyLength) {
+    struct SymTableNode **ppsLink;
     size_t hashIndex;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
-    
-    /*  assert(psCurrentNode->pcValue != NULL);*/
 
-    hashIndex = SymTable_hash(pcKey, oSymTable->numOfLinkedlists);
+    hashIndex = SymTable_bucketOf(oSymTable, uHash,
+        oSymTable->numOfLinkedlists);
+    for (ppsLink = &oSymTable->psFirstNode[hashIndex];
+        *ppsLink != NULL;
+        ppsLink = &(*ppsLink)->psNextNode)
+    {
+        if (SymTable_nodeMatches(oSymTable, *ppsLink, pcKey, uHash,
+            uKeyLength))
+            return ppsLink;
+    }
 
-    for (psCurrentNode = oSymTable->psFirstNode[hashIndex];
-        psCurrentNode != NULL;
-        psCurrentNode =psCurrentNode->psNextNode)
+    if (oSymTable->psOldFirstNode == NULL)
+        return NULL;
+
+    hashIndex = SymTable_bucketOf(oSymTable, uHash,
+        oSymTable->numOfOldLinkedlists);
+    for (ppsLink = &oSymTable->psOldFirstNode[hashIndex];
+        *ppsLink != NULL;
+        ppsLink = &(*ppsLink)->psNextNode)
     {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) return 1;
+        if (SymTable_nodeMatches(oSymTable, *ppsLink, pcKey, uHash,
+            uKeyLength))
+            return ppsLink;
     }
-    return 0; /*Does not find the pcKey */
+    return NULL;
 }
 
-/*--------------------------------------------------------------------*/
 
-void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
-   struct SymTableNode *psCurrentNode;
-   size_t hashIndex;
+/* Return a new node of oSymTable with uKeyBytes bytes of room for an 
+inline key copy, or NULL if insufficient memory is available. */
+
+static struct SymTableNode *SymTable_allocNode(SymTable_T oSymTable,
+     size_t uKeyBytes) {
+    size_t uSize;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
 
-   hashIndex = SymTable_hash(pcKey, oSymTable->numOfLinkedlists);
+    uSize = offsetof(struct SymTableNode, acKey) + uKeyBytes;
+    if (oSymTable->oArena != NULL)
+        return (struct SymTableNode*)
+            SymTableArena_alloc(oSymTable->oArena, uSize);
+    return (struct SymTableNode*)malloc(uSize);
+}
+
 
-    for (psCurrentNode = oSymTable->psFirstNode[hashIndex];
+/*---------------------------------------------------------------------*/
+
+/* Free psNode, a node of oSymTable that is no longer linked. */
+
+static void SymTable_freeNode(SymTable_T oSymTable,
+     struct SymTableNode *psNode) {
+    assert(oSymTable != NULL);
+    assert(psNode != NULL);
+
+    if (oSymTable->oArena != NULL)
+        SymTableArena_release(oSymTable->oArena, psNode,
+            offsetof(struct SymTableNode, acKey) +
+            (psNode->pcKey == psNode->acKey ? psNode->uKeyLength+1 : 0));
+    else
+        free(psNode);
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Free every node, and the key it owns, in the uCount chains of the
+bucket array psBuckets. The array itself is not freed. */
+
+static void SymTable_freeChains(struct SymTableNode **psBuckets,
+     size_t uCount) {
+   struct SymTableNode *psCurrentNode;
+   struct SymTableNode *psNextNode;
+   size_t index;
+
+   assert(psBuckets != NULL);
+
+    for (index = 0; index < uCount; index++) 
+        for (psCurrentNode = psBuckets[index];
         psCurrentNode != NULL;
-        psCurrentNode =psCurrentNode->psNextNode)
-    {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) {
-            return (void*)psCurrentNode -> pvValue;
-        }
-    }
-    return NULL; /*Does not find the pcKey */    
+        psCurrentNode = psNextNode)
+   {
+      psNextNode = psCurrentNode->psNextNode;
+      free(psCurrentNode);
+   }
 }
 
-/*--------------------------------------------------------------------*/
 
-void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
-    struct SymTableNode *psCurrentNode;
-    struct SymTableNode *psPrevNode;
-    const void *value;
-    size_t hashIndex;
+/*---------------------------------------------------------------------*/
+
+/* Return the SymTableImageEntry at offset uEntryOffset in the frozen 
+oSymTable's image, or NULL if the entry, its key or the start of its 
+value lies past the end of the image. openFrozen checks only the header, so 
+every entry is checked here before it is read. */
+
+static const struct SymTableImageEntry *SymTable_frozenEntry(
+     SymTable_T oSymTable, size_t uEntryOffset) {
+    const struct SymTableImageEntry *psEntry;
+    size_t uRoom;
 
     assert(oSymTable != NULL);
-    assert(pcKey != NULL);
-    psPrevNode = NULL;
+    assert(oSymTable->pucImage != NULL);
+
+    if (uEntryOffset % sizeof(size_t) != 0 ||
+        uEntryOffset > oSymTable->uImageSize ||
+        oSymTable->uImageSize - uEntryOffset <
+        sizeof(struct SymTableImageEntry))
+        return NULL;
+    psEntry = (const struct SymTableImageEntry*)
+        (oSymTable->pucImage + uEntryOffset);
+
+    /* The key and its null character must fit after the fields */
+    uRoom = oSymTable->uImageSize - uEntryOffset -
+        sizeof(struct SymTableImageEntry);
+    if (psEntry->uKeyLength >= uRoom ||
+        psEntry->acKey[psEntry->uKeyLength] != '\0')
+        return NULL;
+
+    /* A value of no bytes at the end of the image starts at its end */
+    if (psEntry->uValueOffset > oSymTable->uImageSize)
+        return NULL;
+    return psEntry;
+}
 
-    hashIndex = SymTable_hash(pcKey, oSymTable->numOfLinkedlists);
 
-    /*Searching for key to remove*/
-    for (psCurrentNode = oSymTable->psFirstNode[hashIndex];
-        psCurrentNode != NULL;
-        psCurrentNode = psCurrentNode->psNextNode)
-    {   
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) {
-            /*We found the key to remove*/
-            value = psCurrentNode->pvValue;
-            if (psPrevNode == NULL) {
-                oSymTable->psFirstNode[hashIndex] = psCurrentNode->psNextNode;
-            }
-            else {
-                psPrevNode->psNextNode = psCurrentNode->psNextNode;
-            }
-            free((char*)psCurrentNode->pcKey); 
-            free(psCurrentNode);
-            oSymTable->numBindings--;
-            return (void*)value;
+/*---------------------------------------------------------------------*/
+
+/* Return the SymTableImageEntry of the frozen oSymTable's image whose
+key is the uKeyLength characters at pcKey, or NULL if there is none. */
+
+static const struct SymTableImageEntry *SymTable_findFrozen(
+     SymTable_T oSymTable, const char *pcKey, size_t uKeyLength) {
+    const struct SymTableImageHeader *psHeader;
+    const struct SymTableImageSlot *psSlots;
+    const struct SymTableImageEntry *psEntry;
+    size_t uHash;
+    size_t uMask;
+    size_t uProbes;
+    size_t index;
+
+    assert(oSymTable != NULL);
+    assert(oSymTable->pucImage != NULL);
+    assert(pcKey != NULL);
+
+    psHeader = (const struct SymTableImageHeader*)oSymTable->pucImage;
+    psSlots = (const struct SymTableImageSlot*)
+        (oSymTable->pucImage + sizeof(struct SymTableImageHeader));
+    uHash = SymTable_hashFast(pcKey, uKeyLength);
+    uMask = psHeader->numSlots - 1;
+
+    /* A damaged index may have no empty slot, so stop after one pass */
+    index = uHash & uMask;
+    for (uProbes = 0; uProbes < psHeader->numSlots &&
+        psSlots[index].uEntryOffset != 0; uProbes++) {
+        if (psSlots[index].uHash == uHash) {
+            psEntry = SymTable_frozenEntry(oSymTable,
+                psSlots[index].uEntryOffset);
+            if (psEntry != NULL && psEntry->uKeyLength == uKeyLength &&
+                memcmp(psEntry->acKey, pcKey, uKeyLength) == 0)
+                return psEntry;
         }
-        psPrevNode = psCurrentNode;
+        index = (index + 1) & uMask;
     }
-    return NULL; 
+    return NULL;
 }
 
-/*--------------------------------------------------------------------*/
 
-void SymTable_map(SymTable_T oSymTable,
-               void (*pfApply)(const char *pcKey, void *pvValue,
-                void *pvExtra),
-               const void *pvExtra)
-{
-   struct SymTableNode *psCurrentNode;
-   size_t index;
+/*---------------------------------------------------------------------*/
 
-   assert(oSymTable != NULL);
-   assert(pfApply != NULL);
+/* Return the value of psEntry, an entry of the frozen oSymTable's
+image: the address of its bytes in the image, or NULL. */
 
-   for (index = 0; index < oSymTable->numOfLinkedlists; index++) {
-    for (psCurrentNode = oSymTable->psFirstNode[index];
-        psCurrentNode != NULL;
-        psCurrentNode = psCurrentNode->psNextNode)
-      (*pfApply)(psCurrentNode->pcKey, (void*)psCurrentNode->pvValue,
-       (void*)pvExtra);
+static void *SymTable_frozenValue(SymTable_T oSymTable,
+     const struct SymTableImageEntry *psEntry) {
+    assert(oSymTable != NULL);
+    assert(psEntry != NULL);
+
+    if (psEntry->uValueOffset == 0)
+        return NULL;
+    return (void*)(oSymTable->pucImage + psEntry->uValueOffset);
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/* Create an empty table that grows past dMaxLoadFactor bindings per
+bucket, whose resizes are incremental if iIncremental is 1 (TRUE), and
+whose nodes come from an arena if iArena is 1 (TRUE). Return it, or 
+NULL if insufficient memory is available. */
+
+static SymTable_T SymTable_create(double dMaxLoadFactor, int iIncremental,
+     int iArena)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->pfHash = NULL;
+   oSymTable->pfEqual = NULL;
+   oSymTable->pucImage = NULL;
+   oSymTable->uImageSize = 0;
+   oSymTable->oArena = NULL;
+   if (iArena) {
+    oSymTable->oArena = SymTableArena_new();
+    if (oSymTable->oArena == NULL) {
+     free(oSymTable);
+     return NULL;
+    }
    }
+
+   /* The bucket array is put off until the table outgrows its
+   psSmallBucket */
+   oSymTable->psSmallBucket = NULL;
+   oSymTable->psFirstNode = &oSymTable->psSmallBucket;
+   oSymTable->numBindings = 0;
+   oSymTable->numOfLinkedlists = 1;
+   oSymTable->dMaxLoadFactor = dMaxLoadFactor;
+   oSymTable->psOldFirstNode = NULL;
+   oSymTable->numOfOldLinkedlists = 0;
+   oSymTable->uMigrateIndex = 0;
+   oSymTable->uMinLinkedlists = auBucketCounts[0];
+   oSymTable->iIncremental = iIncremental;
+   oSymTable->uResizeThreads = 1;
+   oSymTable->uOpenIters = 0;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+   return SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 0, 0);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uExpected)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 0, 0);
+   if (oSymTable == NULL)
+      return NULL;
+
+   if (! SymTable_reserve(oSymTable, uExpected))
+   {
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newIncremental(void)
+{
+   return SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 1, 0);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithPolicy(double dMaxLoadFactor)
+{
+   assert(dMaxLoadFactor > 0);
+
+   return SymTable_create(dMaxLoadFactor, 0, 0);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newArena(void)
+{
+   return SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 0, 1);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newParallelResize(size_t uThreads)
+{
+   SymTable_T oSymTable;
+
+   assert(uThreads > 0);
+
+   oSymTable = SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 0, 0);
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->uResizeThreads = uThreads;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithHash(
+   size_t (*pfHash)(const char *pcKey, size_t uLength),
+   int (*pfEqual)(const char *pcKey1, const char *pcKey2, size_t uLength))
+{
+   SymTable_T oSymTable;
+
+   assert(pfHash != NULL);
+
+   oSymTable = SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 0, 0);
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->pfHash = pfHash;
+   oSymTable->pfEqual = pfEqual;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+
+    /* A frozen table owns no nodes, just its mapping */
+    if (oSymTable->pucImage != NULL)
+        SymTableImage_unmap(oSymTable->pucImage, oSymTable->uImageSize);
+
+    /* An arena's nodes all go away with its chunks */
+    if (oSymTable->oArena != NULL)
+        SymTableArena_free(oSymTable->oArena);
+    else {
+        SymTable_freeChains(oSymTable->psFirstNode,
+            oSymTable->numOfLinkedlists);
+        if (oSymTable->psOldFirstNode != NULL)
+            SymTable_freeChains(oSymTable->psOldFirstNode,
+                oSymTable->numOfOldLinkedlists);
+    }
+    if (oSymTable->psOldFirstNode != NULL)
+        SymTable_freeBuckets(oSymTable, oSymTable->psOldFirstNode);
+    SymTable_freeBuckets(oSymTable, oSymTable->psFirstNode);
+    free(oSymTable);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_shrinkToFit(SymTable_T oSymTable)
+{
+    size_t newSize;
+
+    assert(oSymTable != NULL);
+
+    /* Giving memory back also gives up any reservation */
+    oSymTable->uMinLinkedlists = auBucketCounts[0];
+
+    newSize = SymTable_bucketCountFor(oSymTable->numBindings,
+        oSymTable->dMaxLoadFactor);
+    if (newSize < oSymTable->numOfLinkedlists)
+        SymTable_resizeTo(oSymTable, newSize);
+
+    /* Release the old array now, even for an incremental table */
+    SymTable_migrate(oSymTable, oSymTable->numOfOldLinkedlists);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uExpected)
+{
+    size_t newSize;
+
+    assert(oSymTable != NULL);
+
+    /* A small table's psSmallBucket already holds this many */
+    if (oSymTable->psFirstNode == &oSymTable->psSmallBucket &&
+        uExpected <= SMALL_TABLE_CAPACITY)
+        return 1;
+
+    /* Even the largest bucket count would leave the table over its
+    load factor */
+    if ((double)uExpected > oSymTable->dMaxLoadFactor *
+        (double)auBucketCounts[numBucketCounts - 1])
+        return 0;
+
+    newSize = SymTable_bucketCountFor(uExpected,
+        oSymTable->dMaxLoadFactor);
+    if (newSize > oSymTable->numOfLinkedlists) {
+        SymTable_resizeTo(oSymTable, newSize);
+        if (oSymTable->numOfLinkedlists != newSize)
+            return 0;
+    }
+
+    /* The nodes move at once even for an incremental table, so that
+    the loads that follow find a single array */
+    SymTable_migrate(oSymTable, oSymTable->numOfOldLinkedlists);
+    if (newSize > oSymTable->uMinLinkedlists)
+        oSymTable->uMinLinkedlists = newSize;
+    return 1;
+}
+
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getBucketCount(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+
+    return oSymTable->numOfLinkedlists;
+}
+
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+    assert(oSymTable != NULL);
+    return oSymTable->numBindings;
+}
+
+
+/*--------------------------------------------------------------------*/
+
+/* Return the full hash code of pcInterned, a string returned by
+SymTable_intern, under oSymTable's hash function. For the built-in hash
+that is the code stored with the string, so no characters are read. */
+
+static size_t SymTable_internedHash(SymTable_T oSymTable,
+     const char *pcInterned) {
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    if (oSymTable->pfHash == NULL)
+        return SymTableIntern_hash(pcInterned);
+    return (*oSymTable->pfHash)(pcInterned,
+        SymTableIntern_length(pcInterned));
+}
+
+
+/*--------------------------------------------------------------------*/
+
+/* Link a new node binding key pcKey, whose hash code is uHash and 
+whose length is uKeyLength, to value pvValue into oSymTable, which must
+not already contain pcKey. The node gets its own copy of the key if 
+iCopyKey is 1 (TRUE), and otherwise points at pcKey, which must then 
+outlive the binding. Return the new node, or NULL if insufficient 
+memory is available. */
+
+static struct SymTableNode *SymTable_addNode(SymTable_T oSymTable,
+     const char *pcKey, size_t uHash, size_t uKeyLength, int iCopyKey,
+     const void *pvValue) {
+    struct SymTableNode *psNewNode;
+    size_t hashIndex;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    /* Making sure we resize only when necessary */
+    SymTable_resizeIfNeeded(oSymTable);
+
+    /*It is not a duplicate, make space for the new node and key copy*/
+    psNewNode = SymTable_allocNode(oSymTable,
+        iCopyKey ? uKeyLength+1 : 0);
+    if (psNewNode == NULL)
+      return NULL;
+
+    /*We have a space and should copy the key and value and insert the
+    new node. New nodes always go into the current bucket array.*/
+    if (iCopyKey) {
+        memcpy(psNewNode->acKey, pcKey, uKeyLength);
+        psNewNode->acKey[uKeyLength] = '\0';
+        psNewNode->pcKey = psNewNode->acKey;
+    }
+    else
+        psNewNode->pcKey = pcKey;
+    psNewNode->pvValue = pvValue;
+    psNewNode->uHash = uHash;
+    psNewNode->uKeyLength = uKeyLength;
+
+    hashIndex = SymTable_bucketOf(oSymTable, uHash,
+        oSymTable->numOfLinkedlists);
+    psNewNode->psNextNode = oSymTable->psFirstNode[hashIndex];
+    oSymTable->psFirstNode[hashIndex] = psNewNode;
+    oSymTable->numBindings++;
+    return psNewNode; /*Successfully inserted a new node*/
+}
+
+
+/*--------------------------------------------------------------------*/
+
+/* Add a binding of key pcKey, whose hash code is uHash and whose 
+length is uKeyLength, to value pvValue in oSymTable, as SymTable_put
+does. iCopyKey is as for SymTable_addNode. */
+
+static int SymTable_insert(SymTable_T oSymTable, const char *pcKey,
+     size_t uHash, size_t uKeyLength, int iCopyKey,
+     const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    /*Searching for duplicate key*/
+    if (SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength) != NULL)
+        return 0;
+
+    return SymTable_addNode(oSymTable, pcKey, uHash, uKeyLength,
+        iCopyKey, pvValue) != NULL;
+}
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable,
+     const char *pcKey, size_t uLen, const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_insert(oSymTable, pcKey,
+        SymTable_hash(oSymTable, pcKey, uLen), uLen, 1, pvValue);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putK(SymTable_T oSymTable, SymTable_Key sKey,
+     const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(sKey.pcKey != NULL);
+
+    return SymTable_insert(oSymTable, sKey.pcKey,
+        SymTable_keyHash(oSymTable, sKey), sKey.uLength, 1, pvValue);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putInterned(SymTable_T oSymTable,
+     const char *pcInterned, const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    return SymTable_insert(oSymTable, pcInterned,
+        SymTable_internedHash(oSymTable, pcInterned),
+        SymTableIntern_length(pcInterned), 0, pvValue);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_getOrInsert(SymTable_T oSymTable, const char *pcKey,
+     int *piInserted) {
+    struct SymTableNode **ppsLink;
+    struct SymTableNode *psNode;
+    size_t uHash;
+    size_t uKeyLength;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piInserted != NULL);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    /* One hash and one chain walk serve both the lookup and the 
+    insertion */
+    uKeyLength = strlen(pcKey);
+    uHash = SymTable_hash(oSymTable, pcKey, uKeyLength);
+    ppsLink = SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength);
+    if (ppsLink != NULL) {
+        *piInserted = 0;
+        return (void**)&(*ppsLink)->pvValue;
+    }
+
+    psNode = SymTable_addNode(oSymTable, pcKey, uHash, uKeyLength, 1,
+        NULL);
+    if (psNode == NULL)
+        return NULL;
+    *piInserted = 1;
+    return (void**)&psNode->pvValue;
+}
+
+
+/*---------------------------------------------------------------------*/
+
+/*Similar to get but saves the old value, replaces it and returns the
+old value*/
+void *SymTable_replace(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue) { 
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}  
+
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable,
+     const char *pcKey, size_t uLen, const void *pvValue) { 
+    struct SymTableNode **ppsLink;
+    const void *oldValue;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    ppsLink = SymTable_findLink(oSymTable, pcKey,
+        SymTable_hash(oSymTable, pcKey, uLen), uLen);
+    if (ppsLink == NULL)
+        return NULL; /*Does not find the pcKey */
+
+    oldValue = (*ppsLink)->pvValue;
+    (*ppsLink)->pvValue = pvValue;
+    return (void*)oldValue;
+}  
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (oSymTable->pucImage != NULL)
+        return SymTable_findFrozen(oSymTable, pcKey, uLen) != NULL;
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    return SymTable_findLink(oSymTable, pcKey,
+        SymTable_hash(oSymTable, pcKey, uLen), uLen) != NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen) {
+    struct SymTableNode **ppsLink;
+    const struct SymTableImageEntry *psEntry;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    if (oSymTable->pucImage != NULL) {
+        psEntry = SymTable_findFrozen(oSymTable, pcKey, uLen);
+        if (psEntry == NULL)
+            return NULL;
+        return SymTable_frozenValue(oSymTable, psEntry);
+    }
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    ppsLink = SymTable_findLink(oSymTable, pcKey,
+        SymTable_hash(oSymTable, pcKey, uLen), uLen);
+    if (ppsLink == NULL)
+        return NULL; /*Does not find the pcKey */
+    return (void*)(*ppsLink)->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getK(SymTable_T oSymTable, SymTable_Key sKey) {
+    struct SymTableNode **ppsLink;
+
+    assert(oSymTable != NULL);
+    assert(sKey.pcKey != NULL);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    ppsLink = SymTable_findLink(oSymTable, sKey.pcKey,
+        SymTable_keyHash(oSymTable, sKey), sKey.uLength);
+    if (ppsLink == NULL)
+        return NULL; /*Does not find the pcKey */
+    return (void*)(*ppsLink)->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_getMany(SymTable_T oSymTable, const char *apcKeys[],
+     size_t uCount, void *apvValuesOut[]) {
+    size_t auHash[GET_MANY_GROUP];
+    size_t auKeyLength[GET_MANY_GROUP];
+    struct SymTableNode **appsBucket[GET_MANY_GROUP];
+    struct SymTableNode *apsNode[GET_MANY_GROUP];
+    struct SymTableNode **ppsLink;
+    size_t uFirst;
+    size_t uGroup;
+    size_t u;
+    size_t uFound = 0;
+
+    assert(oSymTable != NULL);
+    assert(apcKeys != NULL || uCount == 0);
+    assert(apvValuesOut != NULL || uCount == 0);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    for (uFirst = 0; uFirst < uCount; uFirst += uGroup) {
+        uGroup = uCount - uFirst;
+        if (uGroup > GET_MANY_GROUP)
+            uGroup = GET_MANY_GROUP;
+
+        /* Stage 1: hash every key and start loading its bucket */
+        for (u = 0; u < uGroup; u++) {
+            assert(apcKeys[uFirst+u] != NULL);
+            auKeyLength[u] = strlen(apcKeys[uFirst+u]);
+            auHash[u] = SymTable_hash(oSymTable, apcKeys[uFirst+u],
+                auKeyLength[u]);
+            appsBucket[u] = &oSymTable->psFirstNode[SymTable_bucketOf(
+                oSymTable, auHash[u], oSymTable->numOfLinkedlists)];
+            SymTable_prefetch(appsBucket[u]);
+        }
+
+        /* Stage 2: the buckets have arrived; start loading the first
+        node of each chain */
+        for (u = 0; u < uGroup; u++) {
+            apsNode[u] = *appsBucket[u];
+            if (apsNode[u] != NULL)
+                SymTable_prefetch(apsNode[u]);
+        }
+
+        /* Stage 3: the nodes have arrived; compare. Bindings not yet 
+        moved by an incremental resize need the full search. */
+        for (u = 0; u < uGroup; u++) {
+            while (apsNode[u] != NULL &&
+                !SymTable_nodeMatches(oSymTable, apsNode[u],
+                apcKeys[uFirst+u], auHash[u], auKeyLength[u]))
+                apsNode[u] = apsNode[u]->psNextNode;
+
+            if (apsNode[u] == NULL && oSymTable->psOldFirstNode != NULL) {
+                ppsLink = SymTable_findLink(oSymTable, apcKeys[uFirst+u],
+                    auHash[u], auKeyLength[u]);
+                if (ppsLink != NULL)
+                    apsNode[u] = *ppsLink;
+            }
+
+            if (apsNode[u] == NULL)
+                apvValuesOut[uFirst+u] = NULL;
+            else {
+                apvValuesOut[uFirst+u] = (void*)apsNode[u]->pvValue;
+                uFound++;
+            }
+        }
+    }
+    return uFound;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned) {
+    struct SymTableNode **ppsLink;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    ppsLink = SymTable_findLink(oSymTable, pcInterned,
+        SymTable_internedHash(oSymTable, pcInterned),
+        SymTableIntern_length(pcInterned));
+    if (ppsLink == NULL)
+        return NULL; /*Does not find the pcKey */
+    return (void*)(*ppsLink)->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Remove the binding of key pcKey, whose hash code is uHash and whose 
+length is uKeyLength, from oSymTable and return its value, as 
+SymTable_remove does. */
+
+static void *SymTable_delete(SymTable_T oSymTable, const char *pcKey,
+     size_t uHash, size_t uKeyLength) {
+    struct SymTableNode **ppsLink;
+    struct SymTableNode *psCurrentNode;
+    const void *value;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    SymTable_migrate(oSymTable, MIGRATE_BUCKETS_PER_CALL);
+
+    /*Searching for key to remove*/
+    ppsLink = SymTable_findLink(oSymTable, pcKey, uHash, uKeyLength);
+    if (ppsLink == NULL)
+        return NULL;
+
+    /*We found the key to remove; unlink it from whichever chain holds
+    it*/
+    psCurrentNode = *ppsLink;
+    value = psCurrentNode->pvValue;
+    *ppsLink = psCurrentNode->psNextNode;
+    SymTable_freeNode(oSymTable, psCurrentNode);
+    oSymTable->numBindings--;
+
+    /* Give memory back once the table is mostly empty */
+    SymTable_shrinkIfNeeded(oSymTable);
+    return (void*)value;
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_delete(oSymTable, pcKey,
+        SymTable_hash(oSymTable, pcKey, uLen), uLen);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeK(SymTable_T oSymTable, SymTable_Key sKey) {
+    assert(oSymTable != NULL);
+    assert(sKey.pcKey != NULL);
+
+    return SymTable_delete(oSymTable, sKey.pcKey,
+        SymTable_keyHash(oSymTable, sKey), sKey.uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   struct SymTableNode *psCurrentNode;
+   const struct SymTableImageSlot *psSlots;
+   const struct SymTableImageEntry *psEntry;
+   size_t index;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   if (oSymTable->pucImage != NULL) {
+    psSlots = (const struct SymTableImageSlot*)
+       (oSymTable->pucImage + sizeof(struct SymTableImageHeader));
+    for (index = 0;
+        index < ((const struct SymTableImageHeader*)
+           oSymTable->pucImage)->numSlots;
+        index++) {
+      if (psSlots[index].uEntryOffset == 0)
+         continue;
+      psEntry = SymTable_frozenEntry(oSymTable,
+         psSlots[index].uEntryOffset);
+      if (psEntry == NULL)
+         continue;
+      (*pfApply)(psEntry->acKey, SymTable_frozenValue(oSymTable, psEntry),
+       (void*)pvExtra);
+    }
+    return;
+   }
+
+   for (index = 0; index < oSymTable->numOfLinkedlists; index++) {
+    for (psCurrentNode = oSymTable->psFirstNode[index];
+        psCurrentNode != NULL;
+        psCurrentNode = psCurrentNode->psNextNode)
+      (*pfApply)(psCurrentNode->pcKey, (void*)psCurrentNode->pvValue,
+       (void*)pvExtra);
+   }
+
+   /* Buckets not yet moved by an incremental resize */
+   if (oSymTable->psOldFirstNode != NULL)
+      for (index = oSymTable->uMigrateIndex;
+           index < oSymTable->numOfOldLinkedlists; index++) {
+       for (psCurrentNode = oSymTable->psOldFirstNode[index];
+           psCurrentNode != NULL;
+           psCurrentNode = psCurrentNode->psNextNode)
+         (*pfApply)(psCurrentNode->pcKey, (void*)psCurrentNode->pvValue,
+          (void*)pvExtra);
+      }
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterBegin(SymTable_T oSymTable, SymTable_Iter *psIter)
+{
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   /* Lookups move old buckets, which would shift bindings behind the
+   cursor, so an unfinished incremental resize is finished now. Only a
+   put can start another. */
+   SymTable_migrate(oSymTable, oSymTable->numOfOldLinkedlists);
+   oSymTable->uOpenIters++;
+
+   psIter->oSymTable = oSymTable;
+   psIter->pvNode = NULL;
+   psIter->uBucket = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTable_Iter *psIter, const char **ppcKey,
+     void **ppvValue)
+{
+   SymTable_T oSymTable;
+   const struct SymTableNode *psCurrentNode;
+
+   assert(psIter != NULL);
+   assert(psIter->oSymTable != NULL);
+   assert(ppcKey != NULL);
+   assert(ppvValue != NULL);
+
+   oSymTable = psIter->oSymTable;
+   psCurrentNode = (const struct SymTableNode*)psIter->pvNode;
+   while (psCurrentNode == NULL) {
+    if (psIter->uBucket >= oSymTable->numOfLinkedlists)
+       return 0;
+    psCurrentNode = oSymTable->psFirstNode[psIter->uBucket++];
+   }
+
+   /* Step past the node first, so that the caller may remove it */
+   psIter->pvNode = psCurrentNode->psNextNode;
+   *ppcKey = psCurrentNode->pcKey;
+   *ppvValue = (void*)psCurrentNode->pvValue;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterEnd(SymTable_Iter *psIter)
+{
+   assert(psIter != NULL);
+   assert(psIter->oSymTable != NULL);
+   assert(psIter->oSymTable->uOpenIters > 0);
+
+   /* Removals while the cursor was open did not shrink the table, so
+   catch up on that now */
+   if (--psIter->oSymTable->uOpenIters == 0)
+      SymTable_shrinkIfNeeded(psIter->oSymTable);
+
+   psIter->oSymTable = NULL;
+   psIter->pvNode = NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTableMapJob holds the arguments of one SymTable_mapParallel 
+call for the threads that share it. */
+
+struct SymTableMapJob
+{
+   /* The table */
+   SymTable_T oSymTable;
+
+   /* The function to apply */
+   void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra);
+
+   /* The extra parameter of each thread */
+   void *const *apvExtra;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Apply the function of the SymTableMapJob at pvJob, with thread 
+uThread's extra parameter, to every binding in buckets uBegin to 
+uEnd-1. Indices past the current bucket array stand for the old 
+buckets that an incremental resize has not yet moved. */
+
+static void SymTable_mapBuckets(void *pvJob, size_t uThread,
+               size_t uBegin, size_t uEnd)
+{
+   struct SymTableMapJob *psJob;
+   SymTable_T oSymTable;
+   struct SymTableNode *psCurrentNode;
+   size_t index;
+
+   assert(pvJob != NULL);
+
+   psJob = (struct SymTableMapJob*)pvJob;
+   oSymTable = psJob->oSymTable;
+   for (index = uBegin; index < uEnd; index++) {
+    if (index < oSymTable->numOfLinkedlists)
+      psCurrentNode = oSymTable->psFirstNode[index];
+    else
+      psCurrentNode = oSymTable->psOldFirstNode[oSymTable->uMigrateIndex
+         + index - oSymTable->numOfLinkedlists];
+    for (; psCurrentNode != NULL;
+        psCurrentNode = psCurrentNode->psNextNode)
+      (*psJob->pfApply)(psCurrentNode->pcKey,
+       (void*)psCurrentNode->pvValue, psJob->apvExtra[uThread]);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_mapParallel(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               void *const apvExtra[], size_t uThreads)
+{
+   struct SymTableMapJob sJob;
+   size_t uBuckets;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+   assert(apvExtra != NULL);
+   assert(uThreads > 0);
+   assert(oSymTable->pucImage == NULL);
+
+   sJob.oSymTable = oSymTable;
+   sJob.pfApply = pfApply;
+   sJob.apvExtra = apvExtra;
+
+   uBuckets = oSymTable->numOfLinkedlists;
+   if (oSymTable->psOldFirstNode != NULL)
+      uBuckets += oSymTable->numOfOldLinkedlists - oSymTable->uMigrateIndex;
+   SymTablePool_run(uBuckets, uThreads, SymTable_mapBuckets, &sJob);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return uSize rounded up to a multiple of IMAGE_ALIGN. */
+
+static size_t SymTable_imageAlign(size_t uSize) {
+    return (uSize + IMAGE_ALIGN - 1) / IMAGE_ALIGN * IMAGE_ALIGN;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of bytes that psNode's entry and value take up in
+a frozen image, where pfValueSize gives the size of a value. */
+
+static size_t SymTable_imageEntrySize(const struct SymTableNode *psNode,
+     size_t (*pfValueSize)(const void *pvValue)) {
+    size_t uSize;
+
+    assert(psNode != NULL);
+    assert(pfValueSize != NULL);
+
+    uSize = SymTable_imageAlign(sizeof(struct SymTableImageEntry) +
+        psNode->uKeyLength + 1);
+    if (psNode->pvValue != NULL)
+        uSize += SymTable_imageAlign((*pfValueSize)(psNode->pvValue));
+    return uSize;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write zeros to psFile to pad uSize bytes out to a multiple of 
+IMAGE_ALIGN. Return 1 (TRUE) on success, or 0 (FALSE) on a write 
+error. */
+
+static int SymTable_writePad(FILE *psFile, size_t uSize) {
+    static const char acZeros[IMAGE_ALIGN] = {0};
+    size_t uPad;
+
+    assert(psFile != NULL);
+
+    uPad = SymTable_imageAlign(uSize) - uSize;
+    return fwrite(acZeros, 1, uPad, psFile) == uPad;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the entry of psNode, which starts at offset uOffset of the
+image, and its value to psFile, as SymTable_imageEntrySize lays them 
+out. Return 1 (TRUE) on success, or 0 (FALSE) on a write error. */
+
+static int SymTable_writeEntry(FILE *psFile,
+     const struct SymTableNode *psNode, size_t uOffset,
+     size_t (*pfValueSize)(const void *pvValue)) {
+    struct SymTableImageEntry sEntry;
+    size_t uKeySize;
+    size_t uValueSize;
+
+    assert(psFile != NULL);
+    assert(psNode != NULL);
+    assert(pfValueSize != NULL);
+
+    uKeySize = sizeof(struct SymTableImageEntry) + psNode->uKeyLength + 1;
+    sEntry.uKeyLength = psNode->uKeyLength;
+    sEntry.uValueOffset = 0;
+    if (psNode->pvValue != NULL)
+        sEntry.uValueOffset = uOffset + SymTable_imageAlign(uKeySize);
+
+    if (fwrite(&sEntry, sizeof(struct SymTableImageEntry), 1, psFile) != 1
+        || fwrite(psNode->pcKey, 1, psNode->uKeyLength + 1, psFile) !=
+        psNode->uKeyLength + 1
+        || ! SymTable_writePad(psFile, uKeySize))
+        return 0;
+
+    if (psNode->pvValue == NULL)
+        return 1;
+    uValueSize = (*pfValueSize)(psNode->pvValue);
+    return fwrite(psNode->pvValue, 1, uValueSize, psFile) == uValueSize
+        && SymTable_writePad(psFile, uValueSize);
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_freeze(SymTable_T oSymTable, const char *pcPath,
+     size_t (*pfValueSize)(const void *pvValue)) {
+    struct SymTableImageHeader sHeader;
+    struct SymTableImageSlot *psSlots;
+    struct SymTableNode *psCurrentNode;
+    char *pcTempPath;
+    FILE *psFile;
+    size_t uFirstOffset;
+    size_t uOffset;
+    size_t uHash;
+    size_t uMask;
+    size_t uSlot;
+    size_t index;
+    int iSuccessful;
+
+    assert(oSymTable != NULL);
+    assert(pcPath != NULL);
+    assert(pfValueSize != NULL);
+
+    /* An image compares keys byte for byte */
+    if (oSymTable->pfEqual != NULL)
+        return 0;
+
+    SymTable_migrate(oSymTable, oSymTable->numOfOldLinkedlists);
+
+    memset(&sHeader, 0, sizeof(struct SymTableImageHeader));
+    memcpy(sHeader.acMagic, acImageMagic, sizeof(sHeader.acMagic));
+    sHeader.uHeaderSize = sizeof(struct SymTableImageHeader);
+    sHeader.numBindings = oSymTable->numBindings;
+    sHeader.numSlots = 1;
+    while (sHeader.numSlots < 2 * oSymTable->numBindings)
+        sHeader.numSlots *= 2;
+
+    psSlots = calloc(sHeader.numSlots, sizeof(struct SymTableImageSlot));
+    if (psSlots == NULL)
+        return 0;
+    pcTempPath = malloc(strlen(pcPath) + sizeof(".tmp"));
+    if (pcTempPath == NULL) {
+        free(psSlots);
+        return 0;
+    }
+    strcpy(pcTempPath, pcPath);
+    strcat(pcTempPath, ".tmp");
+
+    /* Lay out the entries in bucket order and index them, always by 
+    SymTable_hashFast so that the image does not depend on a caller's
+    hash function */
+    uMask = sHeader.numSlots - 1;
+    uFirstOffset = SymTable_imageAlign(sizeof(struct SymTableImageHeader)
+        + sHeader.numSlots * sizeof(struct SymTableImageSlot));
+    uOffset = uFirstOffset;
+    for (index = 0; index < oSymTable->numOfLinkedlists; index++)
+        for (psCurrentNode = oSymTable->psFirstNode[index];
+            psCurrentNode != NULL;
+            psCurrentNode = psCurrentNode->psNextNode) {
+            uHash = SymTable_hashFast(psCurrentNode->pcKey,
+                psCurrentNode->uKeyLength);
+            for (uSlot = uHash & uMask; psSlots[uSlot].uEntryOffset != 0;
+                uSlot = (uSlot + 1) & uMask)
+                ;
+            psSlots[uSlot].uHash = uHash;
+            psSlots[uSlot].uEntryOffset = uOffset;
+            uOffset += SymTable_imageEntrySize(psCurrentNode, pfValueSize);
+        }
+    sHeader.uImageSize = uOffset;
+
+    /* The image is written beside pcPath and renamed over it, so that
+    a process that already maps the old image keeps a whole one */
+    psFile = fopen(pcTempPath, "wb");
+    if (psFile == NULL) {
+        free(pcTempPath);
+        free(psSlots);
+        return 0;
+    }
+    iSuccessful =
+        fwrite(&sHeader, sizeof(struct SymTableImageHeader), 1, psFile)
+        == 1 &&
+        fwrite(psSlots, sizeof(struct SymTableImageSlot),
+        sHeader.numSlots, psFile) == sHeader.numSlots &&
+        SymTable_writePad(psFile, sizeof(struct SymTableImageHeader) +
+        sHeader.numSlots * sizeof(struct SymTableImageSlot));
+
+    /* Write the entries in the order they were laid out */
+    uOffset = uFirstOffset;
+    for (index = 0; iSuccessful && index < oSymTable->numOfLinkedlists;
+        index++)
+        for (psCurrentNode = oSymTable->psFirstNode[index];
+            iSuccessful && psCurrentNode != NULL;
+            psCurrentNode = psCurrentNode->psNextNode) {
+            iSuccessful = SymTable_writeEntry(psFile, psCurrentNode,
+                uOffset, pfValueSize);
+            uOffset += SymTable_imageEntrySize(psCurrentNode, pfValueSize);
+        }
+
+    if (fclose(psFile) != 0)
+        iSuccessful = 0;
+    if (iSuccessful)
+        iSuccessful = rename(pcTempPath, pcPath) == 0;
+    if (! iSuccessful)
+        remove(pcTempPath);
+    free(pcTempPath);
+    free(psSlots);
+    return iSuccessful;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_openFrozen(const char *pcPath) {
+    const struct SymTableImageHeader *psHeader;
+    const unsigned char *pucImage;
+    size_t uImageSize;
+    SymTable_T oSymTable;
+
+    assert(pcPath != NULL);
+
+    pucImage = (const unsigned char*)SymTableImage_map(pcPath,
+        &uImageSize);
+    if (pucImage == NULL)
+        return NULL;
+
+    /* Only the header is checked, so that opening touches one page;
+    the rest is read as lookups reach it */
+    psHeader = (const struct SymTableImageHeader*)pucImage;
+    if (uImageSize < sizeof(struct SymTableImageHeader) ||
+        memcmp(psHeader->acMagic, acImageMagic,
+        sizeof(psHeader->acMagic)) != 0 ||
+        psHeader->uHeaderSize != sizeof(struct SymTableImageHeader) ||
+        psHeader->uImageSize != uImageSize ||
+        psHeader->numSlots == 0 ||
+        (psHeader->numSlots & (psHeader->numSlots - 1)) != 0 ||
+        psHeader->numSlots > (uImageSize -
+        sizeof(struct SymTableImageHeader)) /
+        sizeof(struct SymTableImageSlot)) {
+        SymTableImage_unmap(pucImage, uImageSize);
+        return NULL;
+    }
+
+    oSymTable = SymTable_create(DEFAULT_MAX_LOAD_FACTOR, 0, 0);
+    if (oSymTable == NULL) {
+        SymTableImage_unmap(pucImage, uImageSize);
+        return NULL;
+    }
+    oSymTable->pucImage = pucImage;
+    oSymTable->uImageSize = uImageSize;
+    oSymTable->numBindings = psHeader->numBindings;
+    return oSymTable;
 }
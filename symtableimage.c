@@ -0,0 +1,56 @@
+/*--------------------------------------------------------------------*/
+/* symtableimage.c                                                    */
+/* Author: Ndongo Njie                                                */
+/* This file, symtableimage.c, implements the read-only file mapping  */
+/* behind the frozen images of the hash table.                        */
+/*--------------------------------------------------------------------*/
+
+/* mmap, open and fstat are POSIX.1-2001 features */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "symtableimage.h"
+
+/*--------------------------------------------------------------------*/
+
+const void *SymTableImage_map(const char *pcPath, size_t *puSize)
+{
+   struct stat sStat;
+   void *pvImage;
+   int iFd;
+
+   assert(pcPath != NULL);
+   assert(puSize != NULL);
+
+   iFd = open(pcPath, O_RDONLY);
+   if (iFd < 0)
+      return NULL;
+   if (fstat(iFd, &sStat) != 0 || sStat.st_size <= 0)
+   {
+      close(iFd);
+      return NULL;
+   }
+
+   /* The mapping keeps the file alive once the descriptor is closed */
+   pvImage = mmap(NULL, (size_t)sStat.st_size, PROT_READ, MAP_SHARED,
+      iFd, 0);
+   close(iFd);
+   if (pvImage == MAP_FAILED)
+      return NULL;
+
+   *puSize = (size_t)sStat.st_size;
+   return pvImage;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTableImage_unmap(const void *pvImage, size_t uSize)
+{
+   assert(pvImage != NULL);
+
+   munmap((void*)pvImage, uSize);
+}
@@ -0,0 +1,27 @@
+/*--------------------------------------------------------------------*/
+/* symtableimage.h                                                    */
+/* Author: Ndongo Njie                                                */
+/* This file, symtableimage.h, defines the functions used to map a    */
+/* frozen symbol table image into memory read-only.                   */
+/*--------------------------------------------------------------------*/
+
+#ifndef SymTableImage_INCLUDED
+#define SymTableImage_INCLUDED
+#include <stddef.h>
+
+/* Map the whole file at pcPath into memory read-only, store its size
+   in *puSize, and return its address. The pages are shared with every
+   other process that maps the file, and each is read from the file
+   only when first touched. Return NULL if the file cannot be opened or
+   mapped, or is empty. */
+
+const void *SymTableImage_map(const char *pcPath, size_t *puSize);
+
+/*--------------------------------------------------------------------*/
+
+/* Unmap the uSize bytes at pvImage, which SymTableImage_map
+   returned. */
+
+void SymTableImage_unmap(const void *pvImage, size_t uSize);
+
+#endif
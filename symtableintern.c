@@ -0,0 +1,158 @@
+/*--------------------------------------------------------------------*/
+/* symtableintern.c                                                   */
+/* Author: Ndongo Njie                                                */
+/* This file, symtableintern.c, implements the process-wide pool of   */
+/* interned key strings shared by all symbol tables.                  */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symtable.h"
+#include "symtableintern.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+/* The number of buckets of the pool when the first string arrives.
+   The pool doubles (plus one, to stay odd) whenever it holds more
+   strings than buckets. */
+static const size_t INITIAL_BUCKET_COUNT = 1021;
+
+/*--------------------------------------------------------------------*/
+
+/* Each distinct string is stored once in an InternedString, whose
+   characters are what SymTable_intern hands out. InternedStrings are
+   linked to form the chains of the pool. */
+
+struct InternedString
+{
+   /* The address of the next InternedString in the same bucket */
+   struct InternedString *psNextString;
+
+   /* The full hash code of the string */
+   size_t uHash;
+
+   /* The length of the string */
+   size_t uLength;
+
+   /* The characters of the string, stored inline */
+   char acChars[];
+};
+
+/*--------------------------------------------------------------------*/
+
+/* The pool's bucket array, or NULL before the first string arrives */
+static struct InternedString **ppsBuckets = NULL;
+
+/* The number of buckets in ppsBuckets */
+static size_t uBucketCount = 0;
+
+/* The number of strings in the pool */
+static size_t uStringCount = 0;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the InternedString whose characters start at pcInterned. */
+
+static struct InternedString *SymTableIntern_header(
+   const char *pcInterned)
+{
+   assert(pcInterned != NULL);
+
+   return (struct InternedString*)
+      (void*)(pcInterned - offsetof(struct InternedString, acChars));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Move every string of the pool into a bucket array of uNewCount
+   buckets. If memory is short the pool keeps its current size. */
+
+static void SymTableIntern_resize(size_t uNewCount)
+{
+   struct InternedString **ppsNewBuckets;
+   struct InternedString *psString;
+   struct InternedString *psNextString;
+   size_t u;
+   size_t uIndex;
+
+   ppsNewBuckets = calloc(uNewCount, sizeof(struct InternedString *));
+   if (ppsNewBuckets == NULL)
+      return;
+
+   for (u = 0; u < uBucketCount; u++)
+      for (psString = ppsBuckets[u];
+           psString != NULL;
+           psString = psNextString)
+      {
+         psNextString = psString->psNextString;
+         uIndex = psString->uHash % uNewCount;
+         psString->psNextString = ppsNewBuckets[uIndex];
+         ppsNewBuckets[uIndex] = psString;
+      }
+
+   free(ppsBuckets);
+   ppsBuckets = ppsNewBuckets;
+   uBucketCount = uNewCount;
+}
+
+/*--------------------------------------------------------------------*/
+
+const char *SymTable_intern(const char *pcKey)
+{
+   struct InternedString *psString;
+   size_t uHash;
+   size_t uLength;
+   size_t uIndex;
+
+   assert(pcKey != NULL);
+
+   if (ppsBuckets == NULL)
+   {
+      SymTableIntern_resize(INITIAL_BUCKET_COUNT);
+      if (ppsBuckets == NULL)
+         return NULL;
+   }
+
+   uLength = strlen(pcKey);
+   uHash = SymTable_hashFast(pcKey, uLength);
+   uIndex = uHash % uBucketCount;
+   for (psString = ppsBuckets[uIndex];
+        psString != NULL;
+        psString = psString->psNextString)
+      if (psString->uHash == uHash && psString->uLength == uLength &&
+          memcmp(pcKey, psString->acChars, uLength) == 0)
+         return psString->acChars;
+
+   psString = (struct InternedString*)malloc(
+      offsetof(struct InternedString, acChars) + uLength + 1);
+   if (psString == NULL)
+      return NULL;
+   psString->uHash = uHash;
+   psString->uLength = uLength;
+   memcpy(psString->acChars, pcKey, uLength + 1);
+
+   psString->psNextString = ppsBuckets[uIndex];
+   ppsBuckets[uIndex] = psString;
+   uStringCount++;
+
+   if (uStringCount > uBucketCount)
+      SymTableIntern_resize(uBucketCount * 2 + 1);
+   return psString->acChars;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTableIntern_hash(const char *pcInterned)
+{
+   assert(pcInterned != NULL);
+   return SymTableIntern_header(pcInterned)->uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTableIntern_length(const char *pcInterned)
+{
+   assert(pcInterned != NULL);
+   return SymTableIntern_header(pcInterned)->uLength;
+}
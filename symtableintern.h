@@ -0,0 +1,28 @@
+/*--------------------------------------------------------------------*/
+/* symtableintern.h                                                   */
+/* Author: Ndongo Njie                                                */
+/* This file, symtableintern.h, defines the functions the symbol      */
+/* table implementations use to read back what SymTable_intern        */
+/* stored with each interned string.                                  */
+/*--------------------------------------------------------------------*/
+
+#ifndef SymTableIntern_INCLUDED
+#define SymTableIntern_INCLUDED
+#include <stddef.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Return the hash code that SymTable_intern computed for pcInterned,
+   a string that SymTable_intern returned. It is the full, unreduced
+   SymTable_hashFast hash. */
+
+size_t SymTableIntern_hash(const char *pcInterned);
+
+/*--------------------------------------------------------------------*/
+
+/* Return the length of pcInterned, a string that SymTable_intern
+   returned. */
+
+size_t SymTableIntern_length(const char *pcInterned);
+
+#endif
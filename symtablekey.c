@@ -0,0 +1,106 @@
+/*--------------------------------------------------------------------*/
+/* symtablekey.c                                                      */
+/* Author: Ndongo Njie                                                */
+/* This file, symtablekey.c, implements the built-in key hash         */
+/* functions and the prehashed keys shared by the symbol table        */
+/* implementations.                                                   */
+/*--------------------------------------------------------------------*/
+
+#include <assert.h>
+#include "symtable.h"
+#include <string.h>
+
+/*--------------------------------------------------------------------*/
+
+/* Multipliers of the fast hash: odd 64-bit constants with well spread
+   bits, as used by the xxHash family. */
+static const unsigned long long FAST_PRIME_1 = 0x9E3779B185EBCA87ULL;
+static const unsigned long long FAST_PRIME_2 = 0xC2B2AE3D27D4EB4FULL;
+
+/*--------------------------------------------------------------------*/
+
+/* Return the 8 bytes at pcBytes as one word, whatever their
+   alignment. */
+
+static unsigned long long SymTableKey_read64(const char *pcBytes)
+{
+   unsigned long long ullWord;
+
+   assert(pcBytes != NULL);
+
+   memcpy(&ullWord, pcBytes, sizeof(ullWord));
+   return ullWord;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Mix the word ullWord into the running hash ullHash and return the
+   result. */
+
+static unsigned long long SymTableKey_round(unsigned long long ullHash,
+   unsigned long long ullWord)
+{
+   ullHash ^= ullWord * FAST_PRIME_2;
+   ullHash = (ullHash << 31) | (ullHash >> 33);
+   return ullHash * FAST_PRIME_1;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_hashFast(const char *pcKey, size_t uLength)
+{
+   unsigned long long ullHash;
+   unsigned long long ullTail;
+
+   assert(pcKey != NULL);
+
+   ullHash = (unsigned long long)uLength * FAST_PRIME_1;
+   for (; uLength >= 8; uLength -= 8, pcKey += 8)
+      ullHash = SymTableKey_round(ullHash, SymTableKey_read64(pcKey));
+
+   if (uLength > 0)
+   {
+      ullTail = 0;
+      memcpy(&ullTail, pcKey, uLength);
+      ullHash = SymTableKey_round(ullHash, ullTail);
+   }
+
+   /* Final avalanche, so that every output bit (in particular the low
+      32 that tables reduce from) depends on every input bit */
+   ullHash ^= ullHash >> 33;
+   ullHash *= 0xFF51AFD7ED558CCDULL;
+   ullHash ^= ullHash >> 33;
+   ullHash *= 0xC4CEB9FE1A85EC53ULL;
+   ullHash ^= ullHash >> 33;
+   return (size_t)ullHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+size_t SymTable_hashLegacy(const char *pcKey, size_t uLength)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; u < uLength; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   return uHash;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_Key SymTable_makeKey(const char *pcKey)
+{
+   SymTable_Key sKey;
+
+   assert(pcKey != NULL);
+
+   sKey.pcKey = pcKey;
+   sKey.uLength = strlen(pcKey);
+   sKey.uHash = SymTable_hashFast(pcKey, sKey.uLength);
+   return sKey;
+}
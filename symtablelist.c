@@ -8,16 +8,19 @@
 #include <assert.h>
 #include <stdlib.h>
 #include "symtable.h"
+#include "symtablearena.h"
+#include "symtableintern.h"
 #include <string.h>
 
 /*--------------------------------------------------------------------*/
 
 /* Each item is stored in a SymTableNode.  SymTableNodes are linked to
-   form a list.  */
+   form a list. A node and its copy of the key are a single allocation;
+   a node for an interned key points at the interned string instead.  */
 
 struct SymTableNode
 {
-   /* The key */
+   /* The key: acKey, or a string returned by SymTable_intern */
    const char *pcKey;
 
     /* The value*/
@@ -25,6 +28,13 @@ struct SymTableNode
 
    /* The address of the next SymTableNode. */
    struct SymTableNode *psNextNode;
+
+   /* The length of the key, compared before any of its bytes */
+   size_t uKeyLength;
+
+   /* The copy of the key, stored inline right after the fields above;
+      empty for an interned key */
+   char acKey[];
 };
 
 /*--------------------------------------------------------------------*/
@@ -38,10 +48,168 @@ struct SymTable
 
    /* The number of Bindings/Nodes */
    size_t numBindings;
+
+   /* The arena that nodes are carved from, or NULL if each node is
+      allocated with malloc */
+   SymTableArena_T oArena;
+
+   /* 1 (TRUE) if each node found by a lookup is moved to the front */
+   int iMoveToFront;
+
+   /* The number of cursors between SymTable_iterBegin and
+      SymTable_iterEnd. Lookups move nothing while there are any. */
+   size_t uOpenIters;
 };
 
 /*--------------------------------------------------------------------*/
 
+/* Return the number of bytes taken by a node with uKeyBytes bytes of
+   inline key copy. */
+
+static size_t SymTable_nodeSize(size_t uKeyBytes)
+{
+   return offsetof(struct SymTableNode, acKey) + uKeyBytes;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Free psNode, a node of oSymTable that is no longer linked. */
+
+static void SymTable_freeNode(SymTable_T oSymTable,
+   struct SymTableNode *psNode)
+{
+   assert(oSymTable != NULL);
+   assert(psNode != NULL);
+
+   if (oSymTable->oArena != NULL)
+      SymTableArena_release(oSymTable->oArena, psNode,
+         SymTable_nodeSize(psNode->pcKey == psNode->acKey ?
+            psNode->uKeyLength + 1 : 0));
+   else
+      free(psNode);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if psNode holds the key made of the uKeyLength
+   characters at pcKey, and 0 (FALSE) otherwise. The lengths and then
+   the first characters are compared before calling memcmp, so most
+   mismatches are rejected without it. */
+
+static int SymTable_keyEquals(const struct SymTableNode *psNode,
+   const char *pcKey, size_t uKeyLength)
+{
+   assert(psNode != NULL);
+   assert(pcKey != NULL);
+
+   return psNode->uKeyLength == uKeyLength &&
+      (uKeyLength == 0 || (psNode->pcKey[0] == pcKey[0] &&
+      memcmp(pcKey, psNode->pcKey, uKeyLength) == 0));
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Record that a lookup found psNode, which follows psPrevNode (NULL if
+   psNode is first) in oSymTable. In a move-to-front table psNode is
+   relinked at the front, so that keys used often drift towards the
+   front and are found after few comparisons. */
+
+static void SymTable_touch(SymTable_T oSymTable,
+   struct SymTableNode *psPrevNode, struct SymTableNode *psNode)
+{
+   assert(oSymTable != NULL);
+   assert(psNode != NULL);
+
+   if (! oSymTable->iMoveToFront || psPrevNode == NULL ||
+       oSymTable->uOpenIters > 0)
+      return;
+
+   psPrevNode->psNextNode = psNode->psNextNode;
+   psNode->psNextNode = oSymTable->psFirstNode;
+   oSymTable->psFirstNode = psNode;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Link a new node binding the key made of the uKeyLength characters at
+   pcKey to value pvValue at the front of oSymTable, which must not
+   already contain that key. The node gets its own copy of the key if
+   iCopyKey is 1 (TRUE), and otherwise points at pcKey, which must then
+   outlive the binding. Return 1 (TRUE), or 0 (FALSE) if insufficient
+   memory is available. */
+
+static int SymTable_link(SymTable_T oSymTable, const char *pcKey,
+   size_t uKeyLength, int iCopyKey, const void *pvValue)
+{
+   struct SymTableNode *psNewNode;
+   size_t uKeyBytes;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uKeyBytes = iCopyKey ? uKeyLength + 1 : 0;
+   if (oSymTable->oArena != NULL)
+      psNewNode = (struct SymTableNode*)SymTableArena_alloc(
+         oSymTable->oArena, SymTable_nodeSize(uKeyBytes));
+   else
+      psNewNode = (struct SymTableNode*)malloc(
+         SymTable_nodeSize(uKeyBytes));
+   if (psNewNode == NULL)
+      return 0;
+
+   if (iCopyKey)
+   {
+      memcpy(psNewNode->acKey, pcKey, uKeyLength);
+      psNewNode->acKey[uKeyLength] = '\0';
+      psNewNode->pcKey = psNewNode->acKey;
+   }
+   else
+      psNewNode->pcKey = pcKey;
+   psNewNode->pvValue = pvValue;
+   psNewNode->uKeyLength = uKeyLength;
+
+   psNewNode->psNextNode = oSymTable->psFirstNode;
+   oSymTable->psFirstNode = psNewNode;
+   oSymTable->numBindings++;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the node of oSymTable whose key is pcInterned, a string that
+   SymTable_intern returned, or NULL if there is none. Two interned
+   keys are equal only if they are the same pointer, so only nodes
+   holding their own key copy need their bytes compared. */
+
+static struct SymTableNode *SymTable_findInterned(SymTable_T oSymTable,
+   const char *pcInterned)
+{
+   struct SymTableNode *psCurrentNode;
+   struct SymTableNode *psPrevNode = NULL;
+   size_t uKeyLength;
+
+   assert(oSymTable != NULL);
+   assert(pcInterned != NULL);
+
+   uKeyLength = SymTableIntern_length(pcInterned);
+   for (psCurrentNode = oSymTable->psFirstNode;
+        psCurrentNode != NULL;
+        psCurrentNode = psCurrentNode->psNextNode)
+   {
+      if (psCurrentNode->pcKey == pcInterned ||
+          (psCurrentNode->pcKey == psCurrentNode->acKey &&
+           SymTable_keyEquals(psCurrentNode, pcInterned, uKeyLength)))
+      {
+         SymTable_touch(oSymTable, psPrevNode, psCurrentNode);
+         return psCurrentNode;
+      }
+      psPrevNode = psCurrentNode;
+   }
+   return NULL;
+}
+
+/*--------------------------------------------------------------------*/
+
 SymTable_T SymTable_new(void)
 {
    SymTable_T oSymTable;
@@ -52,6 +220,42 @@ SymTable_T SymTable_new(void)
 
    oSymTable->psFirstNode = NULL;
    oSymTable->numBindings = 0;
+   oSymTable->oArena = NULL;
+   oSymTable->iMoveToFront = 0;
+   oSymTable->uOpenIters = 0;
+   return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newArena(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->oArena = SymTableArena_new();
+   if (oSymTable->oArena == NULL)
+   {
+      free(oSymTable);
+      return NULL;
+   }
+   return oSymTable;
+}
+
+/*--------------------------------------------------------------------*/
+
+SymTable_T SymTable_newMoveToFront(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->iMoveToFront = 1;
    return oSymTable;
 }
 
@@ -64,13 +268,19 @@ void SymTable_free(SymTable_T oSymTable)
 
    assert(oSymTable != NULL);
 
+   /* An arena's nodes all go away with its chunks */
+   if (oSymTable->oArena != NULL)
+   {
+      SymTableArena_free(oSymTable->oArena);
+      free(oSymTable);
+      return;
+   }
+
    for (psCurrentNode = oSymTable->psFirstNode;
         psCurrentNode != NULL;
         psCurrentNode = psNextNode)
    {
       psNextNode = psCurrentNode->psNextNode;
-      /* Free where the key points to before freeing the main node */
-      free((char*)psCurrentNode->pcKey); 
       free(psCurrentNode);
    }
    free(oSymTable);
@@ -90,8 +300,18 @@ size_t SymTable_getLength(SymTable_T oSymTable)
 
 int SymTable_put(SymTable_T oSymTable,
      const char *pcKey, const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_putN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_putN(SymTable_T oSymTable,
+     const char *pcKey, size_t uLen, const void *pvValue) {
     struct SymTableNode *psCurrentNode;
-    struct SymTableNode *psNewNode;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
@@ -101,28 +321,57 @@ int SymTable_put(SymTable_T oSymTable,
         psCurrentNode != NULL;
         psCurrentNode =psCurrentNode->psNextNode)
     {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) return 0;
+        if(SymTable_keyEquals(psCurrentNode, pcKey, uLen)) return 0;
     }
-    /* It is not a duplicate, make space for the new node and key copy */
-    psNewNode = (struct SymTableNode*)malloc(sizeof(struct SymTableNode));
-    if (psNewNode == NULL)
-      return 0;
+    /* It is not a duplicate, make space for the new node and key copy
+    and insert it */
+    return SymTable_link(oSymTable, pcKey, uLen, 1, pvValue);
+}
 
-    psNewNode->pcKey = malloc(strlen(pcKey)+1);
-    if (psNewNode->pcKey == NULL) {
-        free(psNewNode);
-        return 0;
-    }
 
-    /* We have a space and should copy the key and value and insert the 
-    new node*/
-    psNewNode->pcKey = strcpy((char*)psNewNode->pcKey, pcKey);
-    psNewNode->pvValue = pvValue;
+/*--------------------------------------------------------------------*/
+
+int SymTable_putInterned(SymTable_T oSymTable,
+     const char *pcInterned, const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    if (SymTable_findInterned(oSymTable, pcInterned) != NULL) return 0;
+    return SymTable_link(oSymTable, pcInterned,
+        SymTableIntern_length(pcInterned), 0, pvValue);
+}
+
+
+/*--------------------------------------------------------------------*/
+
+void **SymTable_getOrInsert(SymTable_T oSymTable, const char *pcKey,
+     int *piInserted) {
+    struct SymTableNode *psCurrentNode;
+    struct SymTableNode *psPrevNode = NULL;
+    size_t uKeyLength;
+
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+    assert(piInserted != NULL);
+
+    uKeyLength = strlen(pcKey);
+    for (psCurrentNode = oSymTable->psFirstNode;
+        psCurrentNode != NULL;
+        psCurrentNode =psCurrentNode->psNextNode)
+    {
+        if(SymTable_keyEquals(psCurrentNode, pcKey, uKeyLength)) {
+            SymTable_touch(oSymTable, psPrevNode, psCurrentNode);
+            *piInserted = 0;
+            return (void**)&psCurrentNode->pvValue;
+        }
+        psPrevNode = psCurrentNode;
+    }
 
-    psNewNode->psNextNode = oSymTable->psFirstNode;
-    oSymTable->psFirstNode = psNewNode;
-    oSymTable->numBindings++;
-    return 1; /* Successfully inserted a new node*/
+    /* Not found: the new node goes to the front of the list */
+    if (! SymTable_link(oSymTable, pcKey, uKeyLength, 1, NULL))
+        return NULL;
+    *piInserted = 1;
+    return (void**)&oSymTable->psFirstNode->pvValue;
 }
 
 
@@ -132,7 +381,19 @@ int SymTable_put(SymTable_T oSymTable,
 value*/
 void *SymTable_replace(SymTable_T oSymTable,
      const char *pcKey, const void *pvValue) { 
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_replaceN(oSymTable, pcKey, strlen(pcKey), pvValue);
+}  
+
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_replaceN(SymTable_T oSymTable,
+     const char *pcKey, size_t uLen, const void *pvValue) { 
     struct SymTableNode *psCurrentNode;
+    struct SymTableNode *psPrevNode = NULL;
     const void *oldValue;
 
 
@@ -143,11 +404,13 @@ void *SymTable_replace(SymTable_T oSymTable,
         psCurrentNode != NULL;
         psCurrentNode =psCurrentNode->psNextNode)
     {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) {
+        if(SymTable_keyEquals(psCurrentNode, pcKey, uLen)) {
+            SymTable_touch(oSymTable, psPrevNode, psCurrentNode);
             oldValue = psCurrentNode-> pvValue;
             psCurrentNode->pvValue = pvValue;
             return (void*)oldValue;
         }
+        psPrevNode = psCurrentNode;
     }
     return NULL; /* Does not find the pcKey */
 }  
@@ -156,7 +419,18 @@ void *SymTable_replace(SymTable_T oSymTable,
 /*--------------------------------------------------------------------*/
 
 int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_containsN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_containsN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen) {
     struct SymTableNode *psCurrentNode;
+    struct SymTableNode *psPrevNode = NULL;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
@@ -165,7 +439,11 @@ int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
         psCurrentNode != NULL;
         psCurrentNode =psCurrentNode->psNextNode)
     {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) return 1;
+        if(SymTable_keyEquals(psCurrentNode, pcKey, uLen)) {
+            SymTable_touch(oSymTable, psPrevNode, psCurrentNode);
+            return 1;
+        }
+        psPrevNode = psCurrentNode;
     }
     return 0; /*Does not find the pcKey */
 }
@@ -173,7 +451,18 @@ int SymTable_contains(SymTable_T oSymTable, const char *pcKey) {
 /*--------------------------------------------------------------------*/
 
 void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_getN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen) {
    struct SymTableNode *psCurrentNode;
+   struct SymTableNode *psPrevNode = NULL;
 
     assert(oSymTable != NULL);
     assert(pcKey != NULL);
@@ -182,16 +471,42 @@ void *SymTable_get(SymTable_T oSymTable, const char *pcKey) {
         psCurrentNode != NULL;
         psCurrentNode =psCurrentNode->psNextNode)
     {
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) {
+        if(SymTable_keyEquals(psCurrentNode, pcKey, uLen)) {
+            SymTable_touch(oSymTable, psPrevNode, psCurrentNode);
             return (void*)psCurrentNode -> pvValue;
         }
+        psPrevNode = psCurrentNode;
     }
     return NULL; /* Does not find the pcKey */   
 }
 
 /*--------------------------------------------------------------------*/
 
+void *SymTable_getInterned(SymTable_T oSymTable, const char *pcInterned) {
+    struct SymTableNode *psNode;
+
+    assert(oSymTable != NULL);
+    assert(pcInterned != NULL);
+
+    psNode = SymTable_findInterned(oSymTable, pcInterned);
+    if (psNode == NULL)
+        return NULL; /* Does not find the pcKey */
+    return (void*)psNode->pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
 void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
+    assert(oSymTable != NULL);
+    assert(pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, pcKey, strlen(pcKey));
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeN(SymTable_T oSymTable, const char *pcKey,
+     size_t uLen) {
     struct SymTableNode *psCurrentNode;
     struct SymTableNode *psPrevNode;
     const void *value;
@@ -205,7 +520,7 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
         psCurrentNode != NULL;
         psCurrentNode = psCurrentNode->psNextNode)
     {   
-        if(strcmp(pcKey,psCurrentNode->pcKey) == 0) {
+        if(SymTable_keyEquals(psCurrentNode, pcKey, uLen)) {
             /* Found the key to remove*/
             value = psCurrentNode->pvValue;
             if (psPrevNode == NULL) {
@@ -214,8 +529,7 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
             else {
                 psPrevNode->psNextNode = psCurrentNode->psNextNode;
             }
-            free((char*)psCurrentNode->pcKey); 
-            free(psCurrentNode);
+            SymTable_freeNode(oSymTable, psCurrentNode);
             oSymTable->numBindings--;
             return (void*)value;
         }
@@ -226,6 +540,36 @@ void *SymTable_remove(SymTable_T oSymTable, const char *pcKey) {
 
 /*--------------------------------------------------------------------*/
 
+/* The list never hashes, so a prehashed key only saves the strlen */
+
+int SymTable_putK(SymTable_T oSymTable, SymTable_Key sKey,
+     const void *pvValue) {
+    assert(oSymTable != NULL);
+    assert(sKey.pcKey != NULL);
+
+    return SymTable_putN(oSymTable, sKey.pcKey, sKey.uLength, pvValue);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_getK(SymTable_T oSymTable, SymTable_Key sKey) {
+    assert(oSymTable != NULL);
+    assert(sKey.pcKey != NULL);
+
+    return SymTable_getN(oSymTable, sKey.pcKey, sKey.uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
+void *SymTable_removeK(SymTable_T oSymTable, SymTable_Key sKey) {
+    assert(oSymTable != NULL);
+    assert(sKey.pcKey != NULL);
+
+    return SymTable_removeN(oSymTable, sKey.pcKey, sKey.uLength);
+}
+
+/*--------------------------------------------------------------------*/
+
 void SymTable_map(SymTable_T oSymTable,
                void (*pfApply)(const char *pcKey, void *pvValue, 
                void *pvExtra), const void *pvExtra)
@@ -240,4 +584,53 @@ void SymTable_map(SymTable_T oSymTable,
         psCurrentNode = psCurrentNode->psNextNode)
       (*pfApply)(psCurrentNode->pcKey, (void*)psCurrentNode->pvValue, 
       (void*)pvExtra);
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterBegin(SymTable_T oSymTable, SymTable_Iter *psIter)
+{
+   assert(oSymTable != NULL);
+   assert(psIter != NULL);
+
+   oSymTable->uOpenIters++;
+   psIter->oSymTable = oSymTable;
+   psIter->pvNode = oSymTable->psFirstNode;
+   psIter->uBucket = 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+int SymTable_iterNext(SymTable_Iter *psIter, const char **ppcKey,
+     void **ppvValue)
+{
+   const struct SymTableNode *psCurrentNode;
+
+   assert(psIter != NULL);
+   assert(psIter->oSymTable != NULL);
+   assert(ppcKey != NULL);
+   assert(ppvValue != NULL);
+
+   psCurrentNode = (const struct SymTableNode*)psIter->pvNode;
+   if (psCurrentNode == NULL)
+      return 0;
+
+   /* Step past the node first, so that the caller may remove it */
+   psIter->pvNode = psCurrentNode->psNextNode;
+   *ppcKey = psCurrentNode->pcKey;
+   *ppvValue = (void*)psCurrentNode->pvValue;
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTable_iterEnd(SymTable_Iter *psIter)
+{
+   assert(psIter != NULL);
+   assert(psIter->oSymTable != NULL);
+   assert(psIter->oSymTable->uOpenIters > 0);
+
+   psIter->oSymTable->uOpenIters--;
+   psIter->oSymTable = NULL;
+   psIter->pvNode = NULL;
 }
\ No newline at end of file
@@ -0,0 +1,433 @@
+/*---------------------------------------------------------------------*/
+/* symtableoa.c                                                        */
+/* Author: Ndongo Njie                                                 */
+/* This file, symtableoa.c, implements symbol table using a flat       */
+/* open addressing hash table with Robin Hood displacement and         */
+/* backward-shift deletion.                                            */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symtable.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------*/
+
+/* The number of slots in a new table. Must be a power of two. */
+static const size_t INITIAL_SLOT_COUNT = 16;
+
+/* The table grows once more than MAX_LOAD_NUM / MAX_LOAD_DEN of its
+   slots are occupied. */
+static const size_t MAX_LOAD_NUM = 7;
+static const size_t MAX_LOAD_DEN = 8;
+
+/*---------------------------------------------------------------------*/
+
+/* Each binding is stored directly in a SymTableSlot of the slot
+   array. A slot whose pcKey is NULL is empty. */
+
+struct SymTableSlot
+{
+   /* The key */
+   const char *pcKey;
+
+   /* The value */
+   const void *pvValue;
+
+   /* The full hash code of pcKey, so that probing and growing never
+      have to read the key bytes of a slot that cannot match. */
+   size_t uHash;
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTable owns one contiguous array of SymTableSlots. */
+
+struct SymTable
+{
+   /* The slot array */
+   struct SymTableSlot *psSlots;
+
+   /* The number of Bindings/Slots in use */
+   size_t numBindings;
+
+   /* The number of slots in psSlots, always a power of two */
+   size_t numSlots;
+};
+
+/*---------------------------------------------------------------------*/
+
+/* Return a hash code for pcKey. The result is the assignment's 65599
+   hash with its high bits folded into the low ones, because slot
+   indices are taken from the low bits only. */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   uHash ^= uHash >> 16;
+   uHash *= (size_t)0x45d9f3b;
+   uHash ^= uHash >> 16;
+   return uHash;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return how far the binding with hash code uHash, stored at slot
+   uIndex of a table with uMask + 1 slots, is from its home slot. */
+
+static size_t SymTable_probeDistance(size_t uHash, size_t uIndex,
+   size_t uMask)
+{
+   return (uIndex - (uHash & uMask)) & uMask;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Place sSlot into psSlots, an array of uMask + 1 slots that has at
+   least one free slot and does not already contain sSlot's key. Richer
+   bindings (closer to home) are displaced in favour of poorer ones. */
+
+static void SymTable_placeSlot(struct SymTableSlot *psSlots,
+   size_t uMask, struct SymTableSlot sSlot)
+{
+   struct SymTableSlot sTemp;
+   size_t uIndex;
+   size_t uDistance;
+   size_t uOtherDistance;
+
+   assert(psSlots != NULL);
+
+   uIndex = sSlot.uHash & uMask;
+   uDistance = 0;
+   while (psSlots[uIndex].pcKey != NULL)
+   {
+      uOtherDistance = SymTable_probeDistance(psSlots[uIndex].uHash,
+         uIndex, uMask);
+      if (uOtherDistance < uDistance)
+      {
+         sTemp = psSlots[uIndex];
+         psSlots[uIndex] = sSlot;
+         sSlot = sTemp;
+         uDistance = uOtherDistance;
+      }
+      uIndex = (uIndex + 1) & uMask;
+      uDistance++;
+   }
+   psSlots[uIndex] = sSlot;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the index of the slot of oSymTable that holds key pcKey,
+   whose hash code is uHash, or oSymTable->numSlots if there is no
+   such slot. */
+
+static size_t SymTable_findSlot(SymTable_T oSymTable, const char *pcKey,
+   size_t uHash)
+{
+   struct SymTableSlot *psSlot;
+   size_t uMask;
+   size_t uIndex;
+   size_t uDistance;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uMask = oSymTable->numSlots - 1;
+   uIndex = uHash & uMask;
+   for (uDistance = 0; ; uDistance++)
+   {
+      psSlot = &oSymTable->psSlots[uIndex];
+      /* An empty slot, or a binding richer than we would be here,
+         means the key cannot be further along. */
+      if (psSlot->pcKey == NULL ||
+          SymTable_probeDistance(psSlot->uHash, uIndex, uMask)
+          < uDistance)
+         return oSymTable->numSlots;
+      if (psSlot->uHash == uHash && strcmp(pcKey, psSlot->pcKey) == 0)
+         return uIndex;
+      uIndex = (uIndex + 1) & uMask;
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the smallest power of two number of slots, at least
+   INITIAL_SLOT_COUNT, that holds uBindings bindings within the load
+   limit, or 0 if no slot array that large could be allocated. */
+
+static size_t SymTable_slotCountFor(size_t uBindings)
+{
+   size_t uCount;
+
+   /* uCount is a multiple of MAX_LOAD_DEN, so dividing first is
+      exact and cannot overflow */
+   uCount = INITIAL_SLOT_COUNT;
+   while (uBindings > uCount / MAX_LOAD_DEN * MAX_LOAD_NUM)
+   {
+      if (uCount > (size_t)-1 / 2 / sizeof(struct SymTableSlot))
+         return 0;
+      uCount *= 2;
+   }
+   return uCount;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Move oSymTable to uNewCount slots, a larger power of two, and
+   re-place every binding. Return 1 (TRUE) on success, or 0 (FALSE)
+   and leave oSymTable unchanged if insufficient memory is
+   available. */
+
+static int SymTable_grow(SymTable_T oSymTable, size_t uNewCount)
+{
+   struct SymTableSlot *psNewSlots;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(uNewCount > oSymTable->numSlots);
+
+   psNewSlots = calloc(uNewCount, sizeof(struct SymTableSlot));
+   if (psNewSlots == NULL)
+      return 0;
+
+   for (u = 0; u < oSymTable->numSlots; u++)
+      if (oSymTable->psSlots[u].pcKey != NULL)
+         SymTable_placeSlot(psNewSlots, uNewCount - 1,
+            oSymTable->psSlots[u]);
+
+   free(oSymTable->psSlots);
+   oSymTable->psSlots = psNewSlots;
+   oSymTable->numSlots = uNewCount;
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->psSlots = calloc(INITIAL_SLOT_COUNT,
+      sizeof(struct SymTableSlot));
+   if (oSymTable->psSlots == NULL)
+   {
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->numBindings = 0;
+   oSymTable->numSlots = INITIAL_SLOT_COUNT;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uExpected)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      return NULL;
+
+   if (! SymTable_reserve(oSymTable, uExpected))
+   {
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uExpected)
+{
+   size_t uNewCount;
+
+   assert(oSymTable != NULL);
+
+   uNewCount = SymTable_slotCountFor(uExpected);
+   if (uNewCount == 0)
+      return 0;
+   if (uNewCount <= oSymTable->numSlots)
+      return 1;
+   return SymTable_grow(oSymTable, uNewCount);
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   for (u = 0; u < oSymTable->numSlots; u++)
+      free((char*)oSymTable->psSlots[u].pcKey);
+   free(oSymTable->psSlots);
+   free(oSymTable);
+}
+
+/*---------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+   return oSymTable->numBindings;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableSlot sSlot;
+   size_t uHash;
+   char *pcKeyCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uHash = SymTable_hash(pcKey);
+   if (SymTable_findSlot(oSymTable, pcKey, uHash) != oSymTable->numSlots)
+      return 0;
+
+   if ((oSymTable->numBindings + 1) * MAX_LOAD_DEN >
+       oSymTable->numSlots * MAX_LOAD_NUM)
+      if (! SymTable_grow(oSymTable, oSymTable->numSlots * 2))
+         return 0;
+
+   pcKeyCopy = malloc(strlen(pcKey) + 1);
+   if (pcKeyCopy == NULL)
+      return 0;
+   strcpy(pcKeyCopy, pcKey);
+
+   sSlot.pcKey = pcKeyCopy;
+   sSlot.pvValue = pvValue;
+   sSlot.uHash = uHash;
+   SymTable_placeSlot(oSymTable->psSlots, oSymTable->numSlots - 1,
+      sSlot);
+   oSymTable->numBindings++;
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   size_t uIndex;
+   const void *oldValue;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uIndex = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+   if (uIndex == oSymTable->numSlots)
+      return NULL;
+
+   oldValue = oSymTable->psSlots[uIndex].pvValue;
+   oSymTable->psSlots[uIndex].pvValue = pvValue;
+   return (void*)oldValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey))
+      != oSymTable->numSlots;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+   size_t uIndex;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uIndex = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+   if (uIndex == oSymTable->numSlots)
+      return NULL;
+   return (void*)oSymTable->psSlots[uIndex].pvValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableSlot *psSlots;
+   size_t uMask;
+   size_t uIndex;
+   size_t uNext;
+   const void *value;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uIndex = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+   if (uIndex == oSymTable->numSlots)
+      return NULL;
+
+   psSlots = oSymTable->psSlots;
+   uMask = oSymTable->numSlots - 1;
+   value = psSlots[uIndex].pvValue;
+   free((char*)psSlots[uIndex].pcKey);
+
+   /* Shift the rest of the probe run back by one slot instead of
+      leaving a tombstone. */
+   uNext = (uIndex + 1) & uMask;
+   while (psSlots[uNext].pcKey != NULL &&
+          SymTable_probeDistance(psSlots[uNext].uHash, uNext, uMask) > 0)
+   {
+      psSlots[uIndex] = psSlots[uNext];
+      uIndex = uNext;
+      uNext = (uNext + 1) & uMask;
+   }
+   psSlots[uIndex].pcKey = NULL;
+   psSlots[uIndex].pvValue = NULL;
+   psSlots[uIndex].uHash = 0;
+
+   oSymTable->numBindings--;
+   return (void*)value;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   struct SymTableSlot *psSlot;
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   for (u = 0; u < oSymTable->numSlots; u++)
+   {
+      psSlot = &oSymTable->psSlots[u];
+      if (psSlot->pcKey != NULL)
+         (*pfApply)(psSlot->pcKey, (void*)psSlot->pvValue,
+            (void*)pvExtra);
+   }
+}
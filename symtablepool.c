@@ -0,0 +1,242 @@
+/*--------------------------------------------------------------------*/
+/* symtablepool.c                                                     */
+/* Author: Ndongo Njie                                                */
+/* This file, symtablepool.c, implements the work-stealing thread     */
+/* pool used by the parallel operations of the hash table.            */
+/*--------------------------------------------------------------------*/
+
+/* pthreads are a POSIX.1-2001 feature */
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "symtablepool.h"
+
+/*--------------------------------------------------------------------*/
+
+/* The range is cut into chunks of at least this many indices */
+enum {MIN_CHUNK_SIZE = 64};
+
+/* Each thread starts with about this many chunks, so that there is
+   something left to steal */
+enum {CHUNKS_PER_THREAD = 16};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTablePoolWorker owns the chunks [uNextChunk, uEndChunk) not yet
+   started. The owner takes chunks from the front and thieves take
+   them from the back, both under sLock. */
+
+struct SymTablePoolWorker
+{
+   /* Guards uNextChunk and uEndChunk */
+   pthread_mutex_t sLock;
+
+   /* The first chunk not yet started */
+   size_t uNextChunk;
+
+   /* One past the last chunk owned */
+   size_t uEndChunk;
+
+   /* The worker's number */
+   size_t uThread;
+
+   /* The job the worker belongs to */
+   struct SymTablePoolJob *psJob;
+
+   /* The worker's pthread, if iStarted */
+   pthread_t sThread;
+
+   /* 1 (TRUE) if sThread was started */
+   int iStarted;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* A SymTablePoolJob describes one call of SymTablePool_run. */
+
+struct SymTablePoolJob
+{
+   /* The function to run on each chunk, and its first argument */
+   void (*pfRange)(void *pvArg, size_t uThread, size_t uBegin,
+      size_t uEnd);
+   void *pvArg;
+
+   /* The size of the whole range */
+   size_t uCount;
+
+   /* The number of indices per chunk */
+   size_t uChunkSize;
+
+   /* The workers */
+   size_t uThreads;
+   struct SymTablePoolWorker *psWorkers;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Take the next chunk of psWorker, store it in *puChunk, and return 1
+   (TRUE), or return 0 (FALSE) if psWorker has none left. */
+
+static int SymTablePool_takeOwn(struct SymTablePoolWorker *psWorker,
+   size_t *puChunk)
+{
+   int iTaken = 0;
+
+   assert(psWorker != NULL);
+   assert(puChunk != NULL);
+
+   pthread_mutex_lock(&psWorker->sLock);
+   if (psWorker->uNextChunk < psWorker->uEndChunk)
+   {
+      *puChunk = psWorker->uNextChunk++;
+      iTaken = 1;
+   }
+   pthread_mutex_unlock(&psWorker->sLock);
+   return iTaken;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Move half of the chunks left to some other worker of psWorker's job
+   to psWorker, which must have none. Return 1 (TRUE) if any were
+   moved, or 0 (FALSE) if every other worker is out of chunks. */
+
+static int SymTablePool_steal(struct SymTablePoolWorker *psWorker)
+{
+   struct SymTablePoolJob *psJob;
+   struct SymTablePoolWorker *psVictim;
+   size_t uLeft;
+   size_t uBegin;
+   size_t uEnd;
+   size_t u;
+
+   assert(psWorker != NULL);
+
+   psJob = psWorker->psJob;
+   for (u = 1; u < psJob->uThreads; u++)
+   {
+      psVictim = &psJob->psWorkers[(psWorker->uThread + u) %
+         psJob->uThreads];
+
+      pthread_mutex_lock(&psVictim->sLock);
+      uLeft = psVictim->uEndChunk - psVictim->uNextChunk;
+      uEnd = psVictim->uEndChunk;
+      uBegin = uEnd - (uLeft + 1) / 2;
+      psVictim->uEndChunk = uBegin;
+      pthread_mutex_unlock(&psVictim->sLock);
+      if (uLeft == 0)
+         continue;
+
+      /* The victim's lock is released first, so two thieves robbing
+         each other cannot deadlock */
+      pthread_mutex_lock(&psWorker->sLock);
+      psWorker->uNextChunk = uBegin;
+      psWorker->uEndChunk = uEnd;
+      pthread_mutex_unlock(&psWorker->sLock);
+      return 1;
+   }
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Run chunks, owned or stolen, for the worker at pvWorker until none
+   are left anywhere. Return NULL. */
+
+static void *SymTablePool_work(void *pvWorker)
+{
+   struct SymTablePoolWorker *psWorker;
+   struct SymTablePoolJob *psJob;
+   size_t uChunk;
+   size_t uBegin;
+   size_t uEnd;
+
+   assert(pvWorker != NULL);
+
+   psWorker = (struct SymTablePoolWorker*)pvWorker;
+   psJob = psWorker->psJob;
+   for (;;)
+   {
+      if (! SymTablePool_takeOwn(psWorker, &uChunk))
+      {
+         if (! SymTablePool_steal(psWorker))
+            return NULL;
+         continue;
+      }
+
+      uBegin = uChunk * psJob->uChunkSize;
+      uEnd = uBegin + psJob->uChunkSize;
+      if (uEnd > psJob->uCount)
+         uEnd = psJob->uCount;
+      (*psJob->pfRange)(psJob->pvArg, psWorker->uThread, uBegin, uEnd);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+void SymTablePool_run(size_t uCount, size_t uThreads,
+   void (*pfRange)(void *pvArg, size_t uThread, size_t uBegin,
+      size_t uEnd),
+   void *pvArg)
+{
+   struct SymTablePoolJob sJob;
+   struct SymTablePoolWorker *psWorker;
+   size_t uChunks;
+   size_t u;
+
+   assert(pfRange != NULL);
+
+   if (uCount == 0)
+      return;
+
+   sJob.uChunkSize = uCount / (uThreads * CHUNKS_PER_THREAD + 1) + 1;
+   if (sJob.uChunkSize < MIN_CHUNK_SIZE)
+      sJob.uChunkSize = MIN_CHUNK_SIZE;
+   uChunks = (uCount + sJob.uChunkSize - 1) / sJob.uChunkSize;
+   if (uThreads > uChunks)
+      uThreads = uChunks;
+
+   /* Not worth a thread, or no memory for the workers */
+   sJob.psWorkers = NULL;
+   if (uThreads > 1)
+      sJob.psWorkers = (struct SymTablePoolWorker*)
+         calloc(uThreads, sizeof(struct SymTablePoolWorker));
+   if (sJob.psWorkers == NULL)
+   {
+      (*pfRange)(pvArg, 0, 0, uCount);
+      return;
+   }
+
+   sJob.pfRange = pfRange;
+   sJob.pvArg = pvArg;
+   sJob.uCount = uCount;
+   sJob.uThreads = uThreads;
+   for (u = 0; u < uThreads; u++)
+   {
+      psWorker = &sJob.psWorkers[u];
+      pthread_mutex_init(&psWorker->sLock, NULL);
+      psWorker->uNextChunk = uChunks * u / uThreads;
+      psWorker->uEndChunk = uChunks * (u + 1) / uThreads;
+      psWorker->uThread = u;
+      psWorker->psJob = &sJob;
+   }
+
+   /* A worker whose thread fails to start has its chunks stolen by the
+      others, thread 0 (the caller) at least */
+   for (u = 1; u < uThreads; u++)
+   {
+      psWorker = &sJob.psWorkers[u];
+      psWorker->iStarted = pthread_create(&psWorker->sThread, NULL,
+         SymTablePool_work, psWorker) == 0;
+   }
+   SymTablePool_work(&sJob.psWorkers[0]);
+
+   for (u = 1; u < uThreads; u++)
+      if (sJob.psWorkers[u].iStarted)
+         pthread_join(sJob.psWorkers[u].sThread, NULL);
+   for (u = 0; u < uThreads; u++)
+      pthread_mutex_destroy(&sJob.psWorkers[u].sLock);
+   free(sJob.psWorkers);
+}
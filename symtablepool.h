@@ -0,0 +1,27 @@
+/*--------------------------------------------------------------------*/
+/* symtablepool.h                                                     */
+/* Author: Ndongo Njie                                                */
+/* This file, symtablepool.h, defines the function used to spread a   */
+/* range of bucket indices over several threads.                      */
+/*--------------------------------------------------------------------*/
+
+#ifndef SymTablePool_INCLUDED
+#define SymTablePool_INCLUDED
+#include <stddef.h>
+
+/* Call (*pfRange)(pvArg, uThread, uBegin, uEnd) for disjoint ranges
+   [uBegin, uEnd) that together cover [0, uCount), on up to uThreads
+   threads, and return once every range is done. uThread, between 0
+   and uThreads-1, tells which thread makes the call; the calling
+   thread is thread 0. Each thread starts with an equal share of the
+   range and, when it runs out, steals half of what another thread
+   has left, so that a few slow ranges do not leave one thread working
+   alone. If threads cannot be started, the calling thread does the
+   work. */
+
+void SymTablePool_run(size_t uCount, size_t uThreads,
+   void (*pfRange)(void *pvArg, size_t uThread, size_t uBegin,
+      size_t uEnd),
+   void *pvArg);
+
+#endif
@@ -0,0 +1,553 @@
+/*---------------------------------------------------------------------*/
+/* symtableswiss.c                                                     */
+/* Author: Ndongo Njie                                                 */
+/* This file, symtableswiss.c, implements symbol table using an open   */
+/* addressing hash table that keeps one control byte per slot and      */
+/* probes 16 control bytes at a time (SSE2 where available).           */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symtable.h"
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/*---------------------------------------------------------------------*/
+
+/* The number of control bytes examined by one probe step. The slot
+   array is divided into aligned groups of this many slots. */
+enum {GROUP_WIDTH = 16};
+
+/* Control byte values. A full slot holds the low 7 bits of its key's
+   hash, so its high bit is always clear; both special values have the
+   high bit set. */
+enum {CTRL_EMPTY = 0x80, CTRL_DELETED = 0xFE};
+
+/* The number of slots in a new table. A multiple of GROUP_WIDTH whose
+   group count is a power of two. */
+static const size_t INITIAL_SLOT_COUNT = GROUP_WIDTH;
+
+/* The table is rebuilt once more than MAX_LOAD_NUM / MAX_LOAD_DEN of
+   its slots are full or deleted. */
+static const size_t MAX_LOAD_NUM = 7;
+static const size_t MAX_LOAD_DEN = 8;
+
+/*---------------------------------------------------------------------*/
+
+/* Each binding is stored directly in a SymTableSlot of the slot
+   array. Whether a slot is in use is recorded only in its control
+   byte. */
+
+struct SymTableSlot
+{
+   /* The key */
+   const char *pcKey;
+
+   /* The value */
+   const void *pvValue;
+
+   /* The full hash code of pcKey, so that rebuilding the table never
+      has to read the key bytes again */
+   size_t uHash;
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTable owns a control byte array and a parallel slot array. */
+
+struct SymTable
+{
+   /* One control byte per slot */
+   unsigned char *pucCtrl;
+
+   /* The slot array */
+   struct SymTableSlot *psSlots;
+
+   /* The number of Bindings/full slots */
+   size_t numBindings;
+
+   /* The number of slots whose control byte is CTRL_DELETED */
+   size_t numDeleted;
+
+   /* The number of slots, a power-of-two multiple of GROUP_WIDTH */
+   size_t numSlots;
+};
+
+/*---------------------------------------------------------------------*/
+
+/* Return a hash code for pcKey. The result is the assignment's 65599
+   hash with its high bits folded into the low ones, because both the
+   group index and the control byte are taken from the low bits. */
+
+static size_t SymTable_hash(const char *pcKey)
+{
+   const size_t HASH_MULTIPLIER = 65599;
+   size_t u;
+   size_t uHash = 0;
+
+   assert(pcKey != NULL);
+
+   for (u = 0; pcKey[u] != '\0'; u++)
+      uHash = uHash * HASH_MULTIPLIER + (size_t)pcKey[u];
+
+   uHash ^= uHash >> 16;
+   uHash *= (size_t)0x45d9f3b;
+   uHash ^= uHash >> 16;
+   return uHash;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the control byte stored for a key whose hash code is uHash. */
+
+static unsigned char SymTable_ctrlOf(size_t uHash)
+{
+   return (unsigned char)(uHash & 0x7F);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the index of the group where the probe sequence for hash
+   code uHash starts, in a table of uGroupMask + 1 groups. */
+
+static size_t SymTable_firstGroup(size_t uHash, size_t uGroupMask)
+{
+   return (uHash >> 7) & uGroupMask;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return a bit mask with bit i set if pucGroup[i] equals ucCtrl, for
+   the GROUP_WIDTH control bytes starting at pucGroup. */
+
+static unsigned int SymTable_matchByte(const unsigned char *pucGroup,
+   unsigned char ucCtrl)
+{
+#if defined(__SSE2__)
+   __m128i sGroup = _mm_loadu_si128((const __m128i*)pucGroup);
+   __m128i sCtrl = _mm_set1_epi8((char)ucCtrl);
+   return (unsigned int)_mm_movemask_epi8(_mm_cmpeq_epi8(sGroup, sCtrl));
+#else
+   unsigned int uMask = 0;
+   int i;
+   for (i = 0; i < GROUP_WIDTH; i++)
+      if (pucGroup[i] == ucCtrl)
+         uMask |= 1u << i;
+   return uMask;
+#endif
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return a bit mask with bit i set if pucGroup[i] is CTRL_EMPTY or
+   CTRL_DELETED, for the GROUP_WIDTH control bytes starting at
+   pucGroup. */
+
+static unsigned int SymTable_matchFree(const unsigned char *pucGroup)
+{
+#if defined(__SSE2__)
+   __m128i sGroup = _mm_loadu_si128((const __m128i*)pucGroup);
+   return (unsigned int)_mm_movemask_epi8(sGroup);
+#else
+   unsigned int uMask = 0;
+   int i;
+   for (i = 0; i < GROUP_WIDTH; i++)
+      if ((pucGroup[i] & 0x80) != 0)
+         uMask |= 1u << i;
+   return uMask;
+#endif
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the position of the lowest set bit of uMask, which must not
+   be 0. */
+
+static size_t SymTable_lowestBit(unsigned int uMask)
+{
+#if defined(__GNUC__)
+   return (size_t)__builtin_ctz(uMask);
+#else
+   size_t u = 0;
+   assert(uMask != 0);
+   while ((uMask & 1u) == 0)
+   {
+      uMask >>= 1;
+      u++;
+   }
+   return u;
+#endif
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the index of the slot of oSymTable that holds key pcKey,
+   whose hash code is uHash, or oSymTable->numSlots if there is no
+   such slot. */
+
+static size_t SymTable_findSlot(SymTable_T oSymTable, const char *pcKey,
+   size_t uHash)
+{
+   const unsigned char *pucGroup;
+   unsigned char ucCtrl;
+   unsigned int uMatches;
+   size_t uGroupMask;
+   size_t uGroup;
+   size_t uStep;
+   size_t uIndex;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   ucCtrl = SymTable_ctrlOf(uHash);
+   uGroupMask = oSymTable->numSlots / GROUP_WIDTH - 1;
+   uGroup = SymTable_firstGroup(uHash, uGroupMask);
+   for (uStep = 1; ; uStep++)
+   {
+      pucGroup = &oSymTable->pucCtrl[uGroup * GROUP_WIDTH];
+      uMatches = SymTable_matchByte(pucGroup, ucCtrl);
+      while (uMatches != 0)
+      {
+         uIndex = uGroup * GROUP_WIDTH + SymTable_lowestBit(uMatches);
+         if (oSymTable->psSlots[uIndex].uHash == uHash &&
+             strcmp(pcKey, oSymTable->psSlots[uIndex].pcKey) == 0)
+            return uIndex;
+         uMatches &= uMatches - 1;
+      }
+      /* A group with an empty slot ends every probe sequence that
+         reaches it. */
+      if (SymTable_matchByte(pucGroup, CTRL_EMPTY) != 0)
+         return oSymTable->numSlots;
+      /* Triangular steps visit every group of a power-of-two table. */
+      uGroup = (uGroup + uStep) & uGroupMask;
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the index of the first empty or deleted slot on the probe
+   sequence for hash code uHash in the table whose control bytes are
+   pucCtrl and which has uSlotCount slots. There must be one. */
+
+static size_t SymTable_findFree(const unsigned char *pucCtrl,
+   size_t uSlotCount, size_t uHash)
+{
+   unsigned int uFree;
+   size_t uGroupMask;
+   size_t uGroup;
+   size_t uStep;
+
+   assert(pucCtrl != NULL);
+
+   uGroupMask = uSlotCount / GROUP_WIDTH - 1;
+   uGroup = SymTable_firstGroup(uHash, uGroupMask);
+   for (uStep = 1; ; uStep++)
+   {
+      uFree = SymTable_matchFree(&pucCtrl[uGroup * GROUP_WIDTH]);
+      if (uFree != 0)
+         return uGroup * GROUP_WIDTH + SymTable_lowestBit(uFree);
+      uGroup = (uGroup + uStep) & uGroupMask;
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the smallest number of slots, at least INITIAL_SLOT_COUNT
+   and a power of two, that holds uBindings bindings within the load
+   limit, or 0 if no slot arrays that large could be allocated. */
+
+static size_t SymTable_slotCountFor(size_t uBindings)
+{
+   size_t uCount;
+
+   /* uCount is a multiple of MAX_LOAD_DEN, so dividing first is
+      exact and cannot overflow */
+   uCount = INITIAL_SLOT_COUNT;
+   while (uBindings > uCount / MAX_LOAD_DEN * MAX_LOAD_NUM)
+   {
+      if (uCount > (size_t)-1 / 2 / sizeof(struct SymTableSlot))
+         return 0;
+      uCount *= 2;
+   }
+   return uCount;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Rebuild oSymTable with uNewCount slots, dropping every deleted
+   marker. Return 1 (TRUE) on success, or 0 (FALSE) and leave oSymTable
+   unchanged if insufficient memory is available. */
+
+static int SymTable_rehash(SymTable_T oSymTable, size_t uNewCount)
+{
+   unsigned char *pucNewCtrl;
+   struct SymTableSlot *psNewSlots;
+   size_t u;
+   size_t uHash;
+   size_t uIndex;
+
+   assert(oSymTable != NULL);
+
+   pucNewCtrl = malloc(uNewCount);
+   if (pucNewCtrl == NULL)
+      return 0;
+   psNewSlots = malloc(uNewCount * sizeof(struct SymTableSlot));
+   if (psNewSlots == NULL)
+   {
+      free(pucNewCtrl);
+      return 0;
+   }
+   memset(pucNewCtrl, CTRL_EMPTY, uNewCount);
+
+   for (u = 0; u < oSymTable->numSlots; u++)
+   {
+      if ((oSymTable->pucCtrl[u] & 0x80) != 0)
+         continue;
+      uHash = oSymTable->psSlots[u].uHash;
+      uIndex = SymTable_findFree(pucNewCtrl, uNewCount, uHash);
+      pucNewCtrl[uIndex] = SymTable_ctrlOf(uHash);
+      psNewSlots[uIndex] = oSymTable->psSlots[u];
+   }
+
+   free(oSymTable->pucCtrl);
+   free(oSymTable->psSlots);
+   oSymTable->pucCtrl = pucNewCtrl;
+   oSymTable->psSlots = psNewSlots;
+   oSymTable->numSlots = uNewCount;
+   oSymTable->numDeleted = 0;
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->pucCtrl = malloc(INITIAL_SLOT_COUNT);
+   oSymTable->psSlots = malloc(INITIAL_SLOT_COUNT *
+      sizeof(struct SymTableSlot));
+   if (oSymTable->pucCtrl == NULL || oSymTable->psSlots == NULL)
+   {
+      free(oSymTable->pucCtrl);
+      free(oSymTable->psSlots);
+      free(oSymTable);
+      return NULL;
+   }
+   memset(oSymTable->pucCtrl, CTRL_EMPTY, INITIAL_SLOT_COUNT);
+
+   oSymTable->numBindings = 0;
+   oSymTable->numDeleted = 0;
+   oSymTable->numSlots = INITIAL_SLOT_COUNT;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_newWithCapacity(size_t uExpected)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = SymTable_new();
+   if (oSymTable == NULL)
+      return NULL;
+
+   if (! SymTable_reserve(oSymTable, uExpected))
+   {
+      SymTable_free(oSymTable);
+      return NULL;
+   }
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_reserve(SymTable_T oSymTable, size_t uExpected)
+{
+   size_t uNewCount;
+
+   assert(oSymTable != NULL);
+
+   uNewCount = SymTable_slotCountFor(uExpected);
+   if (uNewCount == 0)
+      return 0;
+   if (uNewCount <= oSymTable->numSlots)
+      return 1;
+   return SymTable_rehash(oSymTable, uNewCount);
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+   size_t u;
+
+   assert(oSymTable != NULL);
+
+   for (u = 0; u < oSymTable->numSlots; u++)
+      if ((oSymTable->pucCtrl[u] & 0x80) == 0)
+         free((char*)oSymTable->psSlots[u].pcKey);
+   free(oSymTable->pucCtrl);
+   free(oSymTable->psSlots);
+   free(oSymTable);
+}
+
+/*---------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+   return oSymTable->numBindings;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   size_t uHash;
+   size_t uIndex;
+   size_t uNewCount;
+   char *pcKeyCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uHash = SymTable_hash(pcKey);
+   if (SymTable_findSlot(oSymTable, pcKey, uHash) != oSymTable->numSlots)
+      return 0;
+
+   if ((oSymTable->numBindings + oSymTable->numDeleted + 1) *
+       MAX_LOAD_DEN > oSymTable->numSlots * MAX_LOAD_NUM)
+   {
+      /* Grow only if live bindings need it; otherwise just clear out
+         the deleted markers at the current size. */
+      uNewCount = oSymTable->numSlots;
+      if ((oSymTable->numBindings + 1) * 2 * MAX_LOAD_DEN >
+          oSymTable->numSlots * MAX_LOAD_NUM)
+         uNewCount *= 2;
+      if (! SymTable_rehash(oSymTable, uNewCount))
+         return 0;
+   }
+
+   pcKeyCopy = malloc(strlen(pcKey) + 1);
+   if (pcKeyCopy == NULL)
+      return 0;
+   strcpy(pcKeyCopy, pcKey);
+
+   uIndex = SymTable_findFree(oSymTable->pucCtrl, oSymTable->numSlots,
+      uHash);
+   if (oSymTable->pucCtrl[uIndex] == CTRL_DELETED)
+      oSymTable->numDeleted--;
+   oSymTable->pucCtrl[uIndex] = SymTable_ctrlOf(uHash);
+   oSymTable->psSlots[uIndex].pcKey = pcKeyCopy;
+   oSymTable->psSlots[uIndex].pvValue = pvValue;
+   oSymTable->psSlots[uIndex].uHash = uHash;
+   oSymTable->numBindings++;
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   size_t uIndex;
+   const void *oldValue;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uIndex = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+   if (uIndex == oSymTable->numSlots)
+      return NULL;
+
+   oldValue = oSymTable->psSlots[uIndex].pvValue;
+   oSymTable->psSlots[uIndex].pvValue = pvValue;
+   return (void*)oldValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey))
+      != oSymTable->numSlots;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+   size_t uIndex;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uIndex = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+   if (uIndex == oSymTable->numSlots)
+      return NULL;
+   return (void*)oSymTable->psSlots[uIndex].pvValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+   const unsigned char *pucGroup;
+   size_t uIndex;
+   const void *value;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   uIndex = SymTable_findSlot(oSymTable, pcKey, SymTable_hash(pcKey));
+   if (uIndex == oSymTable->numSlots)
+      return NULL;
+
+   value = oSymTable->psSlots[uIndex].pvValue;
+   free((char*)oSymTable->psSlots[uIndex].pcKey);
+   oSymTable->psSlots[uIndex].pcKey = NULL;
+
+   /* If the group still has an empty slot, no probe sequence ever went
+      past it, so this slot can become empty rather than deleted. */
+   pucGroup = &oSymTable->pucCtrl[uIndex - uIndex % GROUP_WIDTH];
+   if (SymTable_matchByte(pucGroup, CTRL_EMPTY) != 0)
+      oSymTable->pucCtrl[uIndex] = CTRL_EMPTY;
+   else
+   {
+      oSymTable->pucCtrl[uIndex] = CTRL_DELETED;
+      oSymTable->numDeleted++;
+   }
+
+   oSymTable->numBindings--;
+   return (void*)value;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   size_t u;
+
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   for (u = 0; u < oSymTable->numSlots; u++)
+      if ((oSymTable->pucCtrl[u] & 0x80) == 0)
+         (*pfApply)(oSymTable->psSlots[u].pcKey,
+            (void*)oSymTable->psSlots[u].pvValue, (void*)pvExtra);
+}
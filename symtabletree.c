@@ -0,0 +1,702 @@
+/*---------------------------------------------------------------------*/
+/* symtabletree.c                                                      */
+/* Author: Ndongo Njie                                                 */
+/* This file, symtabletree.c, implements symbol table using a B-tree   */
+/* with wide nodes, which keeps the bindings in key order.             */
+/*---------------------------------------------------------------------*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include "symtable.h"
+#include <string.h>
+
+/*---------------------------------------------------------------------*/
+
+/* Every node but the root holds between MIN_DEGREE - 1 and MAX_KEYS
+   bindings, and an internal node has one more child than bindings.
+   Wide nodes keep the tree shallow, so a lookup touches a handful of
+   nodes whose key arrays are each searched within a few cache lines. */
+enum {MIN_DEGREE = 16};
+enum {MAX_KEYS = 2 * MIN_DEGREE - 1};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTableNode holds its bindings in ascending strcmp order of
+   their keys. The keys of apsChildren[i] all sort between
+   apcKeys[i-1] and apcKeys[i]. Leaves are allocated without room for
+   apsChildren. */
+
+struct SymTableNode
+{
+   /* The number of bindings in the node */
+   size_t numKeys;
+
+   /* 1 (TRUE) if the node has no children */
+   int iLeaf;
+
+   /* The keys */
+   const char *apcKeys[MAX_KEYS];
+
+   /* The values, apvValues[i] belonging to apcKeys[i] */
+   const void *apvValues[MAX_KEYS];
+
+   /* The children, if the node is not a leaf */
+   struct SymTableNode *apsChildren[];
+};
+
+/*---------------------------------------------------------------------*/
+
+/* A SymTable points to the root of its B-tree. */
+
+struct SymTable
+{
+   /* The root, which is a leaf with no bindings in an empty table */
+   struct SymTableNode *psRoot;
+
+   /* The number of Bindings */
+   size_t numBindings;
+};
+
+/*---------------------------------------------------------------------*/
+
+/* Return a new node with no bindings, a leaf if iLeaf is 1 (TRUE), or
+   NULL if insufficient memory is available. */
+
+static struct SymTableNode *SymTable_newNode(int iLeaf)
+{
+   struct SymTableNode *psNode;
+   size_t uSize;
+
+   uSize = sizeof(struct SymTableNode);
+   if (! iLeaf)
+      uSize += (MAX_KEYS + 1) * sizeof(struct SymTableNode*);
+
+   psNode = (struct SymTableNode*)malloc(uSize);
+   if (psNode == NULL)
+      return NULL;
+
+   psNode->numKeys = 0;
+   psNode->iLeaf = iLeaf;
+   return psNode;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Free psNode, its subtrees and their keys. */
+
+static void SymTable_freeNode(struct SymTableNode *psNode)
+{
+   size_t u;
+
+   assert(psNode != NULL);
+
+   for (u = 0; u < psNode->numKeys; u++)
+      free((char*)psNode->apcKeys[u]);
+   if (! psNode->iLeaf)
+      for (u = 0; u <= psNode->numKeys; u++)
+         SymTable_freeNode(psNode->apsChildren[u]);
+   free(psNode);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the index of the first key of psNode that does not sort
+   before pcKey, or psNode->numKeys if there is none. Set *piFound to
+   1 (TRUE) if that key equals pcKey, and to 0 (FALSE) otherwise. */
+
+static size_t SymTable_lowerBound(const struct SymTableNode *psNode,
+   const char *pcKey, int *piFound)
+{
+   size_t uLow = 0;
+   size_t uHigh;
+   size_t uMid;
+   int iCompare;
+
+   assert(psNode != NULL);
+   assert(pcKey != NULL);
+   assert(piFound != NULL);
+
+   *piFound = 0;
+   uHigh = psNode->numKeys;
+   while (uLow < uHigh)
+   {
+      uMid = uLow + (uHigh - uLow) / 2;
+      iCompare = strcmp(psNode->apcKeys[uMid], pcKey);
+      if (iCompare == 0)
+      {
+         *piFound = 1;
+         return uMid;
+      }
+      if (iCompare < 0)
+         uLow = uMid + 1;
+      else
+         uHigh = uMid;
+   }
+   return uLow;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Return the node of oSymTable that holds pcKey and store the key's
+   index in it in *puIndex, or return NULL if there is no such key. */
+
+static struct SymTableNode *SymTable_find(SymTable_T oSymTable,
+   const char *pcKey, size_t *puIndex)
+{
+   struct SymTableNode *psNode;
+   size_t uIndex;
+   int iFound;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+   assert(puIndex != NULL);
+
+   psNode = oSymTable->psRoot;
+   for (;;)
+   {
+      uIndex = SymTable_lowerBound(psNode, pcKey, &iFound);
+      if (iFound)
+      {
+         *puIndex = uIndex;
+         return psNode;
+      }
+      if (psNode->iLeaf)
+         return NULL;
+      psNode = psNode->apsChildren[uIndex];
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Insert pcKey and pvValue into psNode at uIndex, moving the later
+   bindings (and, for an internal node, the children after them) up
+   one place. psChild becomes the child just after the new binding.
+   psNode must not be full. */
+
+static void SymTable_insertAt(struct SymTableNode *psNode, size_t uIndex,
+   const char *pcKey, const void *pvValue, struct SymTableNode *psChild)
+{
+   size_t uMoved;
+
+   assert(psNode != NULL);
+   assert(psNode->numKeys < MAX_KEYS);
+   assert(uIndex <= psNode->numKeys);
+
+   uMoved = psNode->numKeys - uIndex;
+   memmove(&psNode->apcKeys[uIndex + 1], &psNode->apcKeys[uIndex],
+      uMoved * sizeof(const char*));
+   memmove(&psNode->apvValues[uIndex + 1], &psNode->apvValues[uIndex],
+      uMoved * sizeof(const void*));
+   psNode->apcKeys[uIndex] = pcKey;
+   psNode->apvValues[uIndex] = pvValue;
+   if (! psNode->iLeaf)
+   {
+      memmove(&psNode->apsChildren[uIndex + 2],
+         &psNode->apsChildren[uIndex + 1],
+         uMoved * sizeof(struct SymTableNode*));
+      psNode->apsChildren[uIndex + 1] = psChild;
+   }
+   psNode->numKeys++;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Remove the binding at uIndex of psNode, and for an internal node the
+   child just after it, moving the later ones down one place. */
+
+static void SymTable_removeAt(struct SymTableNode *psNode, size_t uIndex)
+{
+   size_t uMoved;
+
+   assert(psNode != NULL);
+   assert(uIndex < psNode->numKeys);
+
+   uMoved = psNode->numKeys - uIndex - 1;
+   memmove(&psNode->apcKeys[uIndex], &psNode->apcKeys[uIndex + 1],
+      uMoved * sizeof(const char*));
+   memmove(&psNode->apvValues[uIndex], &psNode->apvValues[uIndex + 1],
+      uMoved * sizeof(const void*));
+   if (! psNode->iLeaf)
+      memmove(&psNode->apsChildren[uIndex + 1],
+         &psNode->apsChildren[uIndex + 2],
+         uMoved * sizeof(struct SymTableNode*));
+   psNode->numKeys--;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Split the full child uIndex of psParent, which must not be full, in
+   two around its middle binding, which moves up into psParent. Return
+   1 (TRUE), or 0 (FALSE) if insufficient memory is available, in which
+   case nothing changes. */
+
+static int SymTable_splitChild(struct SymTableNode *psParent,
+   size_t uIndex)
+{
+   struct SymTableNode *psLeft;
+   struct SymTableNode *psRight;
+
+   assert(psParent != NULL);
+   assert(! psParent->iLeaf);
+
+   psLeft = psParent->apsChildren[uIndex];
+   assert(psLeft->numKeys == MAX_KEYS);
+
+   psRight = SymTable_newNode(psLeft->iLeaf);
+   if (psRight == NULL)
+      return 0;
+
+   psRight->numKeys = MIN_DEGREE - 1;
+   memcpy(psRight->apcKeys, &psLeft->apcKeys[MIN_DEGREE],
+      (MIN_DEGREE - 1) * sizeof(const char*));
+   memcpy(psRight->apvValues, &psLeft->apvValues[MIN_DEGREE],
+      (MIN_DEGREE - 1) * sizeof(const void*));
+   if (! psLeft->iLeaf)
+      memcpy(psRight->apsChildren, &psLeft->apsChildren[MIN_DEGREE],
+         MIN_DEGREE * sizeof(struct SymTableNode*));
+   psLeft->numKeys = MIN_DEGREE - 1;
+
+   SymTable_insertAt(psParent, uIndex, psLeft->apcKeys[MIN_DEGREE - 1],
+      psLeft->apvValues[MIN_DEGREE - 1], psRight);
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Append the binding at uIndex of psParent and all of child uIndex + 1
+   to child uIndex, which together hold at most MAX_KEYS bindings, and
+   remove them from psParent. */
+
+static void SymTable_mergeChildren(struct SymTableNode *psParent,
+   size_t uIndex)
+{
+   struct SymTableNode *psLeft;
+   struct SymTableNode *psRight;
+   size_t uBase;
+
+   assert(psParent != NULL);
+   assert(uIndex < psParent->numKeys);
+
+   psLeft = psParent->apsChildren[uIndex];
+   psRight = psParent->apsChildren[uIndex + 1];
+   assert(psLeft->numKeys + psRight->numKeys < MAX_KEYS);
+
+   uBase = psLeft->numKeys;
+   psLeft->apcKeys[uBase] = psParent->apcKeys[uIndex];
+   psLeft->apvValues[uBase] = psParent->apvValues[uIndex];
+   memcpy(&psLeft->apcKeys[uBase + 1], psRight->apcKeys,
+      psRight->numKeys * sizeof(const char*));
+   memcpy(&psLeft->apvValues[uBase + 1], psRight->apvValues,
+      psRight->numKeys * sizeof(const void*));
+   if (! psLeft->iLeaf)
+      memcpy(&psLeft->apsChildren[uBase + 1], psRight->apsChildren,
+         (psRight->numKeys + 1) * sizeof(struct SymTableNode*));
+   psLeft->numKeys += psRight->numKeys + 1;
+
+   SymTable_removeAt(psParent, uIndex);
+   free(psRight);
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Make sure child uIndex of psParent holds at least MIN_DEGREE
+   bindings, by borrowing one through psParent from a sibling that can
+   spare it or else merging the child with a sibling. Return the index
+   of the child that now covers the keys child uIndex covered. */
+
+static size_t SymTable_fillChild(struct SymTableNode *psParent,
+   size_t uIndex)
+{
+   struct SymTableNode *psChild;
+   struct SymTableNode *psSibling;
+
+   assert(psParent != NULL);
+   assert(! psParent->iLeaf);
+
+   psChild = psParent->apsChildren[uIndex];
+   if (psChild->numKeys >= MIN_DEGREE)
+      return uIndex;
+
+   if (uIndex > 0 &&
+       psParent->apsChildren[uIndex - 1]->numKeys >= MIN_DEGREE)
+   {
+      /* Rotate the left sibling's last binding through psParent */
+      psSibling = psParent->apsChildren[uIndex - 1];
+      SymTable_insertAt(psChild, 0, psParent->apcKeys[uIndex - 1],
+         psParent->apvValues[uIndex - 1], NULL);
+      if (! psChild->iLeaf)
+      {
+         /* insertAt put the new child after the binding; it belongs
+            before it */
+         psChild->apsChildren[1] = psChild->apsChildren[0];
+         psChild->apsChildren[0] =
+            psSibling->apsChildren[psSibling->numKeys];
+      }
+      psParent->apcKeys[uIndex - 1] =
+         psSibling->apcKeys[psSibling->numKeys - 1];
+      psParent->apvValues[uIndex - 1] =
+         psSibling->apvValues[psSibling->numKeys - 1];
+      psSibling->numKeys--;
+      return uIndex;
+   }
+
+   if (uIndex < psParent->numKeys &&
+       psParent->apsChildren[uIndex + 1]->numKeys >= MIN_DEGREE)
+   {
+      /* Rotate the right sibling's first binding through psParent */
+      psSibling = psParent->apsChildren[uIndex + 1];
+      psChild->apcKeys[psChild->numKeys] = psParent->apcKeys[uIndex];
+      psChild->apvValues[psChild->numKeys] = psParent->apvValues[uIndex];
+      if (! psChild->iLeaf)
+         psChild->apsChildren[psChild->numKeys + 1] =
+            psSibling->apsChildren[0];
+      psChild->numKeys++;
+      psParent->apcKeys[uIndex] = psSibling->apcKeys[0];
+      psParent->apvValues[uIndex] = psSibling->apvValues[0];
+      if (! psSibling->iLeaf)
+         memmove(&psSibling->apsChildren[0], &psSibling->apsChildren[1],
+            psSibling->numKeys * sizeof(struct SymTableNode*));
+      memmove(&psSibling->apcKeys[0], &psSibling->apcKeys[1],
+         (psSibling->numKeys - 1) * sizeof(const char*));
+      memmove(&psSibling->apvValues[0], &psSibling->apvValues[1],
+         (psSibling->numKeys - 1) * sizeof(const void*));
+      psSibling->numKeys--;
+      return uIndex;
+   }
+
+   if (uIndex < psParent->numKeys)
+   {
+      SymTable_mergeChildren(psParent, uIndex);
+      return uIndex;
+   }
+   SymTable_mergeChildren(psParent, uIndex - 1);
+   return uIndex - 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Detach the binding with key pcKey from the subtree at psNode, which
+   must contain it and, unless it is the root, hold at least MIN_DEGREE
+   bindings, and store its key and value in *ppcKey and *ppvValue.
+   The key is not freed. Nodes on the way down are topped up first, so
+   that no node is ever left with too few bindings. */
+
+static void SymTable_detach(struct SymTableNode *psNode,
+   const char *pcKey, const char **ppcKey, const void **ppvValue)
+{
+   struct SymTableNode *psNeighbour;
+   size_t uIndex;
+   int iFound;
+
+   assert(psNode != NULL);
+   assert(pcKey != NULL);
+   assert(ppcKey != NULL);
+   assert(ppvValue != NULL);
+
+   for (;;)
+   {
+      uIndex = SymTable_lowerBound(psNode, pcKey, &iFound);
+      if (iFound && psNode->iLeaf)
+      {
+         *ppcKey = psNode->apcKeys[uIndex];
+         *ppvValue = psNode->apvValues[uIndex];
+         SymTable_removeAt(psNode, uIndex);
+         return;
+      }
+      assert(! psNode->iLeaf);
+
+      if (iFound && psNode->apsChildren[uIndex]->numKeys >= MIN_DEGREE)
+      {
+         /* Replace the binding with its predecessor, the last binding
+            of the left subtree, and detach that instead */
+         *ppcKey = psNode->apcKeys[uIndex];
+         *ppvValue = psNode->apvValues[uIndex];
+         for (psNeighbour = psNode->apsChildren[uIndex];
+              ! psNeighbour->iLeaf;
+              psNeighbour = psNeighbour->apsChildren[psNeighbour->numKeys])
+            ;
+         pcKey = psNeighbour->apcKeys[psNeighbour->numKeys - 1];
+         SymTable_detach(psNode->apsChildren[uIndex], pcKey,
+            &psNode->apcKeys[uIndex], &psNode->apvValues[uIndex]);
+         return;
+      }
+
+      if (iFound &&
+          psNode->apsChildren[uIndex + 1]->numKeys >= MIN_DEGREE)
+      {
+         /* Likewise with the successor */
+         *ppcKey = psNode->apcKeys[uIndex];
+         *ppvValue = psNode->apvValues[uIndex];
+         for (psNeighbour = psNode->apsChildren[uIndex + 1];
+              ! psNeighbour->iLeaf;
+              psNeighbour = psNeighbour->apsChildren[0])
+            ;
+         pcKey = psNeighbour->apcKeys[0];
+         SymTable_detach(psNode->apsChildren[uIndex + 1], pcKey,
+            &psNode->apcKeys[uIndex], &psNode->apvValues[uIndex]);
+         return;
+      }
+
+      /* Either both neighbouring children are minimal, in which case
+         the binding is merged down between them, or the key lies in
+         child uIndex, which is topped up before descending */
+      if (iFound)
+         SymTable_mergeChildren(psNode, uIndex);
+      else
+         uIndex = SymTable_fillChild(psNode, uIndex);
+      psNode = psNode->apsChildren[uIndex];
+   }
+}
+
+/*---------------------------------------------------------------------*/
+
+/* Apply pfApply, with pvExtra, to each binding of the subtree at
+   psNode whose key is not before pcLow and is before pcHigh, in
+   ascending key order. A NULL bound is no bound. */
+
+static void SymTable_mapNode(const struct SymTableNode *psNode,
+   const char *pcLow, const char *pcHigh,
+   void (*pfApply)(const char *pcKey, void *pvValue, void *pvExtra),
+   void *pvExtra)
+{
+   size_t u = 0;
+   int iFound;
+
+   assert(psNode != NULL);
+   assert(pfApply != NULL);
+
+   /* The children before the first key not below pcLow hold only keys
+      below it */
+   if (pcLow != NULL)
+      u = SymTable_lowerBound(psNode, pcLow, &iFound);
+
+   for (; u < psNode->numKeys; u++)
+   {
+      if (! psNode->iLeaf)
+         SymTable_mapNode(psNode->apsChildren[u], pcLow, pcHigh,
+            pfApply, pvExtra);
+      if (pcHigh != NULL && strcmp(psNode->apcKeys[u], pcHigh) >= 0)
+         return;
+      (*pfApply)(psNode->apcKeys[u], (void*)psNode->apvValues[u],
+         pvExtra);
+   }
+   if (! psNode->iLeaf)
+      SymTable_mapNode(psNode->apsChildren[u], pcLow, pcHigh, pfApply,
+         pvExtra);
+}
+
+/*---------------------------------------------------------------------*/
+
+SymTable_T SymTable_new(void)
+{
+   SymTable_T oSymTable;
+
+   oSymTable = (SymTable_T)malloc(sizeof(struct SymTable));
+   if (oSymTable == NULL)
+      return NULL;
+
+   oSymTable->psRoot = SymTable_newNode(1);
+   if (oSymTable->psRoot == NULL)
+   {
+      free(oSymTable);
+      return NULL;
+   }
+
+   oSymTable->numBindings = 0;
+   return oSymTable;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_free(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+
+   SymTable_freeNode(oSymTable->psRoot);
+   free(oSymTable);
+}
+
+/*---------------------------------------------------------------------*/
+
+size_t SymTable_getLength(SymTable_T oSymTable)
+{
+   assert(oSymTable != NULL);
+   return oSymTable->numBindings;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_put(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableNode *psNode;
+   struct SymTableNode *psNewRoot;
+   size_t uIndex;
+   int iFound;
+   char *pcKeyCopy;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   if (SymTable_find(oSymTable, pcKey, &uIndex) != NULL)
+      return 0;
+
+   pcKeyCopy = malloc(strlen(pcKey) + 1);
+   if (pcKeyCopy == NULL)
+      return 0;
+   strcpy(pcKeyCopy, pcKey);
+
+   /* A full root is split under a new root, the only way the tree
+      grows taller */
+   if (oSymTable->psRoot->numKeys == MAX_KEYS)
+   {
+      psNewRoot = SymTable_newNode(0);
+      if (psNewRoot == NULL)
+      {
+         free(pcKeyCopy);
+         return 0;
+      }
+      psNewRoot->apsChildren[0] = oSymTable->psRoot;
+      if (! SymTable_splitChild(psNewRoot, 0))
+      {
+         free(psNewRoot);
+         free(pcKeyCopy);
+         return 0;
+      }
+      oSymTable->psRoot = psNewRoot;
+   }
+
+   /* Full nodes are split on the way down, so the leaf reached has
+      room. A split that fails leaves a valid tree behind. */
+   psNode = oSymTable->psRoot;
+   while (! psNode->iLeaf)
+   {
+      uIndex = SymTable_lowerBound(psNode, pcKey, &iFound);
+      if (psNode->apsChildren[uIndex]->numKeys == MAX_KEYS)
+      {
+         if (! SymTable_splitChild(psNode, uIndex))
+         {
+            free(pcKeyCopy);
+            return 0;
+         }
+         if (strcmp(pcKey, psNode->apcKeys[uIndex]) > 0)
+            uIndex++;
+      }
+      psNode = psNode->apsChildren[uIndex];
+   }
+
+   uIndex = SymTable_lowerBound(psNode, pcKey, &iFound);
+   SymTable_insertAt(psNode, uIndex, pcKeyCopy, pvValue, NULL);
+   oSymTable->numBindings++;
+   return 1;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_replace(SymTable_T oSymTable,
+     const char *pcKey, const void *pvValue)
+{
+   struct SymTableNode *psNode;
+   size_t uIndex;
+   const void *oldValue;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   psNode = SymTable_find(oSymTable, pcKey, &uIndex);
+   if (psNode == NULL)
+      return NULL;
+
+   oldValue = psNode->apvValues[uIndex];
+   psNode->apvValues[uIndex] = pvValue;
+   return (void*)oldValue;
+}
+
+/*---------------------------------------------------------------------*/
+
+int SymTable_contains(SymTable_T oSymTable, const char *pcKey)
+{
+   size_t uIndex;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   return SymTable_find(oSymTable, pcKey, &uIndex) != NULL;
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_get(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableNode *psNode;
+   size_t uIndex;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   psNode = SymTable_find(oSymTable, pcKey, &uIndex);
+   if (psNode == NULL)
+      return NULL;
+   return (void*)psNode->apvValues[uIndex];
+}
+
+/*---------------------------------------------------------------------*/
+
+void *SymTable_remove(SymTable_T oSymTable, const char *pcKey)
+{
+   struct SymTableNode *psRoot;
+   size_t uIndex;
+   const char *pcOldKey;
+   const void *value;
+
+   assert(oSymTable != NULL);
+   assert(pcKey != NULL);
+
+   /* Only a key that is present is worth restructuring the tree for */
+   if (SymTable_find(oSymTable, pcKey, &uIndex) == NULL)
+      return NULL;
+
+   SymTable_detach(oSymTable->psRoot, pcKey, &pcOldKey, &value);
+   free((char*)pcOldKey);
+
+   /* A root emptied by a merge gives way to its only child, the only
+      way the tree grows shorter */
+   psRoot = oSymTable->psRoot;
+   if (psRoot->numKeys == 0 && ! psRoot->iLeaf)
+   {
+      oSymTable->psRoot = psRoot->apsChildren[0];
+      free(psRoot);
+   }
+
+   oSymTable->numBindings--;
+   return (void*)value;
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_map(SymTable_T oSymTable,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   SymTable_mapNode(oSymTable->psRoot, NULL, NULL, pfApply,
+      (void*)pvExtra);
+}
+
+/*---------------------------------------------------------------------*/
+
+void SymTable_mapRange(SymTable_T oSymTable,
+               const char *pcLow, const char *pcHigh,
+               void (*pfApply)(const char *pcKey, void *pvValue,
+                void *pvExtra),
+               const void *pvExtra)
+{
+   assert(oSymTable != NULL);
+   assert(pfApply != NULL);
+
+   SymTable_mapNode(oSymTable->psRoot, pcLow, pcHigh, pfApply,
+      (void*)pvExtra);
+}
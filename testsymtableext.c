@@ -0,0 +1,403 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableext.c                                                  */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtableext.c, tests the functions that both the    */
+/* linked list and the hash table implementations of symtable.h       */
+/* provide beyond the basic interface.                                */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "testsymtableutil.h"
+
+/*--------------------------------------------------------------------*/
+
+/* The number of keys most tests use */
+enum {TEST_KEYS = 5000};
+
+/*--------------------------------------------------------------------*/
+
+/* Test the length-delimited functions: keys that are not terminated,
+   keys that are prefixes of one another, and keys holding '\0'. */
+
+static void testLengthDelimited(void)
+{
+   /* "abc" appears twice, unterminated the first time */
+   static const char acBuffer[] = "abcdabc\0x";
+   static const char acNulKey[] = {'a', '\0', 'b'};
+   static const char acNulKey2[] = {'a', '\0', 'c'};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH + 1];
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing the length-delimited functions.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* A key is just its bytes, wherever they come from */
+   ASSURE(SymTable_putN(oSymTable, acBuffer, 3, &acValues[0]));
+   ASSURE(! SymTable_putN(oSymTable, &acBuffer[4], 3, &acValues[1]));
+   ASSURE(! SymTable_put(oSymTable, "abc", &acValues[1]));
+   ASSURE(SymTable_get(oSymTable, "abc") == &acValues[0]);
+   ASSURE(SymTable_getN(oSymTable, "abcdef", 3) == &acValues[0]);
+   ASSURE(SymTable_containsN(oSymTable, &acBuffer[4], 3));
+
+   /* A prefix, or a longer key, is a different key */
+   ASSURE(! SymTable_containsN(oSymTable, acBuffer, 2));
+   ASSURE(! SymTable_containsN(oSymTable, acBuffer, 4));
+   ASSURE(SymTable_getN(oSymTable, acBuffer, 4) == NULL);
+   ASSURE(SymTable_putN(oSymTable, acBuffer, 4, &acValues[2]));
+   ASSURE(SymTable_putN(oSymTable, acBuffer, 0, &acValues[3]));
+   ASSURE(SymTable_get(oSymTable, "abcd") == &acValues[2]);
+   ASSURE(SymTable_get(oSymTable, "") == &acValues[3]);
+   ASSURE(SymTable_getLength(oSymTable) == 3);
+
+   /* Keys holding '\0' differ from the string that ends there */
+   ASSURE(SymTable_putN(oSymTable, acNulKey, 3, &acValues[4]));
+   ASSURE(SymTable_putN(oSymTable, acNulKey2, 3, &acValues[5]));
+   ASSURE(! SymTable_contains(oSymTable, "a"));
+   ASSURE(SymTable_getN(oSymTable, acNulKey, 3) == &acValues[4]);
+   ASSURE(SymTable_getN(oSymTable, acNulKey2, 3) == &acValues[5]);
+   ASSURE(SymTable_put(oSymTable, "a", &acValues[6]));
+   ASSURE(SymTable_getN(oSymTable, acNulKey, 1) == &acValues[6]);
+   ASSURE(SymTable_getLength(oSymTable) == 6);
+
+   ASSURE(SymTable_replaceN(oSymTable, acNulKey, 3, &acValues[7])
+      == &acValues[4]);
+   ASSURE(SymTable_replaceN(oSymTable, acNulKey, 2, &acValues[7])
+      == NULL);
+   ASSURE(SymTable_getN(oSymTable, acNulKey, 3) == &acValues[7]);
+   ASSURE(SymTable_removeN(oSymTable, acNulKey, 3) == &acValues[7]);
+   ASSURE(SymTable_removeN(oSymTable, acNulKey, 3) == NULL);
+   ASSURE(SymTable_getN(oSymTable, acNulKey2, 3) == &acValues[5]);
+   ASSURE(SymTable_get(oSymTable, "a") == &acValues[6]);
+   ASSURE(SymTable_removeN(oSymTable, "abcdef", 3) == &acValues[0]);
+   ASSURE(! SymTable_contains(oSymTable, "abc"));
+   ASSURE(SymTable_contains(oSymTable, "abcd"));
+   ASSURE(SymTable_getLength(oSymTable) == 4);
+   SymTable_free(oSymTable);
+
+   /* Many keys, each read from an unterminated buffer */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < TEST_KEYS; i++)
+   {
+      makeKey(acKey, i);
+      acKey[strlen(acKey)] = '#';
+      ASSURE(SymTable_putN(oSymTable, acKey,
+         strchr(acKey, '#') - acKey, &acValues[i]));
+   }
+   for (i = 0; i < TEST_KEYS; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_getN(oSymTable, acKey, strlen(acKey))
+         == &acValues[i]);
+      ASSURE(SymTable_get(oSymTable, acKey) == &acValues[i]);
+   }
+   for (i = 0; i < TEST_KEYS; i += 2)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_removeN(oSymTable, acKey, strlen(acKey))
+         == &acValues[i]);
+   }
+   for (i = 0; i < TEST_KEYS; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_containsN(oSymTable, acKey, strlen(acKey))
+         == (i % 2 == 1));
+   }
+   ASSURE(SymTable_getLength(oSymTable) == TEST_KEYS / 2);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_getOrInsert on both of its paths, and as a counter
+   that is bumped in place through the returned slot. */
+
+static void testGetOrInsert(void)
+{
+   enum {ROUNDS = 3};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   void **ppvSlot;
+   int iInserted;
+   int iRound;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_getOrInsert.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   /* The insert path binds the key to NULL */
+   iInserted = 0;
+   ppvSlot = SymTable_getOrInsert(oSymTable, "alpha", &iInserted);
+   ASSURE(ppvSlot != NULL);
+   ASSURE(iInserted == 1);
+   ASSURE(*ppvSlot == NULL);
+   ASSURE(SymTable_contains(oSymTable, "alpha"));
+   ASSURE(SymTable_get(oSymTable, "alpha") == NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 1);
+
+   /* A store through the slot is the binding's value */
+   *ppvSlot = &acValues[0];
+   ASSURE(SymTable_get(oSymTable, "alpha") == &acValues[0]);
+
+   /* The found path returns the same binding and adds nothing */
+   iInserted = 1;
+   ppvSlot = SymTable_getOrInsert(oSymTable, "alpha", &iInserted);
+   ASSURE(ppvSlot != NULL);
+   ASSURE(iInserted == 0);
+   ASSURE(*ppvSlot == &acValues[0]);
+   *ppvSlot = &acValues[1];
+   ASSURE(SymTable_get(oSymTable, "alpha") == &acValues[1]);
+   ASSURE(SymTable_getLength(oSymTable) == 1);
+
+   /* A binding made by SymTable_put is found too */
+   ASSURE(SymTable_put(oSymTable, "beta", &acValues[2]));
+   ppvSlot = SymTable_getOrInsert(oSymTable, "beta", &iInserted);
+   ASSURE(ppvSlot != NULL);
+   ASSURE(iInserted == 0);
+   ASSURE(*ppvSlot == &acValues[2]);
+   ASSURE(SymTable_remove(oSymTable, "beta") == &acValues[2]);
+   ppvSlot = SymTable_getOrInsert(oSymTable, "beta", &iInserted);
+   ASSURE(ppvSlot != NULL);
+   ASSURE(iInserted == 1);
+   ASSURE(*ppvSlot == NULL);
+   SymTable_free(oSymTable);
+
+   /* Count ROUNDS sightings of many keys, each held in the value
+      pointer as an offset into acValues */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (iRound = 0; iRound < ROUNDS; iRound++)
+      for (i = 0; i < TEST_KEYS; i++)
+      {
+         makeKey(acKey, i);
+         ppvSlot = SymTable_getOrInsert(oSymTable, acKey, &iInserted);
+         ASSURE(ppvSlot != NULL);
+         ASSURE(iInserted == (iRound == 0));
+         if (iInserted)
+            *ppvSlot = &acValues[0];
+         ASSURE(*ppvSlot == &acValues[iRound]);
+         *ppvSlot = (char*)*ppvSlot + 1;
+      }
+   ASSURE(SymTable_getLength(oSymTable) == TEST_KEYS);
+   for (i = 0; i < TEST_KEYS; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &acValues[ROUNDS]);
+   }
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test prehashed SymTable_Key tokens, each made once and used with
+   several tables. */
+
+static void testKeyTokens(void)
+{
+   enum {TABLE_COUNT = 3};
+
+   SymTable_T aoSymTables[TABLE_COUNT];
+   static SymTable_Key asKeys[TEST_KEYS];
+   static char aacKeys[TEST_KEYS][MAX_KEY_LENGTH];
+   SymTable_Key sKey;
+   int iTable;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_Key tokens.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   sKey = SymTable_makeKey("token");
+   ASSURE(strcmp(sKey.pcKey, "token") == 0);
+   ASSURE(sKey.uLength == 5);
+   ASSURE(sKey.uHash == SymTable_hashFast("token", 5));
+
+   for (i = 0; i < TEST_KEYS; i++)
+   {
+      makeKey(aacKeys[i], i);
+      asKeys[i] = SymTable_makeKey(aacKeys[i]);
+   }
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+   {
+      aoSymTables[iTable] = SymTable_new();
+      ASSURE(aoSymTables[iTable] != NULL);
+   }
+
+   /* Table t holds every key whose number is a multiple of t+1 */
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+      for (i = 0; i < TEST_KEYS; i += iTable + 1)
+      {
+         ASSURE(SymTable_putK(aoSymTables[iTable], asKeys[i],
+            &acValues[i]));
+         ASSURE(! SymTable_putK(aoSymTables[iTable], asKeys[i],
+            &acValues[0]));
+      }
+
+   /* Tokens and plain strings reach the same bindings */
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+   {
+      ASSURE(SymTable_getLength(aoSymTables[iTable]) ==
+         (size_t)((TEST_KEYS + iTable) / (iTable + 1)));
+      for (i = 0; i < TEST_KEYS; i++)
+      {
+         if (i % (iTable + 1) == 0)
+         {
+            ASSURE(SymTable_getK(aoSymTables[iTable], asKeys[i])
+               == &acValues[i]);
+            ASSURE(SymTable_get(aoSymTables[iTable], aacKeys[i])
+               == &acValues[i]);
+         }
+         else
+            ASSURE(SymTable_getK(aoSymTables[iTable], asKeys[i])
+               == NULL);
+      }
+   }
+
+   ASSURE(SymTable_put(aoSymTables[1], "token", &acValues[1]));
+   ASSURE(SymTable_getK(aoSymTables[1], sKey) == &acValues[1]);
+   ASSURE(SymTable_removeK(aoSymTables[1], sKey) == &acValues[1]);
+   ASSURE(SymTable_removeK(aoSymTables[1], sKey) == NULL);
+   ASSURE(! SymTable_contains(aoSymTables[1], "token"));
+
+   for (iTable = 0; iTable < TABLE_COUNT; iTable++)
+   {
+      for (i = 0; i < TEST_KEYS; i += iTable + 1)
+         ASSURE(SymTable_removeK(aoSymTables[iTable], asKeys[i])
+            == &acValues[i]);
+      ASSURE(SymTable_getLength(aoSymTables[iTable]) == 0);
+      SymTable_free(aoSymTables[iTable]);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a cursor over a table made by (*pfNew)() that removes each
+   binding as it is returned, and one that looks up and replaces
+   values as it goes. Every binding must be returned exactly once even
+   though the removals leave the table almost empty. */
+
+static void testIterRemove(SymTable_T (*pfNew)(void))
+{
+   enum {KEY_COUNT = TEST_KEYS};
+
+   static char acVisits[TEST_KEYS];
+   SymTable_T oSymTable;
+   SymTable_Iter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   const char *pcKey;
+   void *pvValue;
+   int iVisited;
+   int i;
+
+   assert(pfNew != NULL);
+
+   oSymTable = (*pfNew)();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_put(oSymTable, acKey, &acValues[i]));
+   }
+
+   /* Look up and replace each value as it is returned */
+   memset(acVisits, 0, sizeof(acVisits));
+   iVisited = 0;
+   SymTable_iterBegin(oSymTable, &sIter);
+   while (SymTable_iterNext(&sIter, &pcKey, &pvValue))
+   {
+      i = (int)((char*)pvValue - acValues);
+      ASSURE(i >= 0 && i < KEY_COUNT);
+      makeKey(acKey, i);
+      ASSURE(strcmp(pcKey, acKey) == 0);
+      ASSURE(SymTable_get(oSymTable, "key0") == &acValues[0]);
+      ASSURE(SymTable_replace(oSymTable, pcKey, pvValue) == pvValue);
+      acVisits[i]++;
+      iVisited++;
+   }
+   SymTable_iterEnd(&sIter);
+   ASSURE(iVisited == KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(acVisits[i] == 1);
+
+   /* Remove each binding as it is returned */
+   memset(acVisits, 0, sizeof(acVisits));
+   iVisited = 0;
+   SymTable_iterBegin(oSymTable, &sIter);
+   while (SymTable_iterNext(&sIter, &pcKey, &pvValue))
+   {
+      i = (int)((char*)pvValue - acValues);
+      ASSURE(i >= 0 && i < KEY_COUNT);
+      acVisits[i]++;
+      iVisited++;
+      ASSURE(SymTable_remove(oSymTable, pcKey) == pvValue);
+   }
+   SymTable_iterEnd(&sIter);
+   ASSURE(iVisited == KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(acVisits[i] == 1);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   /* The table must still work once the cursor is closed */
+   makeKey(acKey, 1);
+   ASSURE(! SymTable_contains(oSymTable, acKey));
+   ASSURE(SymTable_put(oSymTable, acKey, &acValues[1]));
+   ASSURE(SymTable_get(oSymTable, acKey) == &acValues[1]);
+   ASSURE(SymTable_getLength(oSymTable) == 1);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the cursors on plain tables and on tables whose nodes come
+   from an arena. */
+
+static void testIterators(void)
+{
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_iterBegin, SymTable_iterNext and "
+      "SymTable_iterEnd.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   testIterRemove(SymTable_new);
+   testIterRemove(SymTable_newArena);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the functions that both the linked list and the hash table
+   implementations provide beyond the basic interface. The
+   command-line arguments are ignored. Return 0. */
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+
+   testLengthDelimited();
+   testGetOrInsert();
+   testKeyTokens();
+   testIterators();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
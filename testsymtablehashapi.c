@@ -0,0 +1,1100 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablehashapi.c                                              */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtablehashapi.c, tests the functions that only    */
+/* the hash table implementation of symtable.h provides.              */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "testsymtableutil.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Return 1 (TRUE) if oSymTable binds key number i to its value, and
+   0 (FALSE) otherwise. */
+
+static int holdsKey(SymTable_T oSymTable, int i)
+{
+   char acKey[MAX_KEY_LENGTH];
+
+   assert(oSymTable != NULL);
+
+   makeKey(acKey, i);
+   return SymTable_contains(oSymTable, acKey) &&
+      SymTable_get(oSymTable, acKey) == &acValues[i];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Put key number i, bound to its value, into oSymTable, and return
+   what SymTable_put returns. */
+
+static int putKey(SymTable_T oSymTable, int i)
+{
+   char acKey[MAX_KEY_LENGTH];
+
+   assert(oSymTable != NULL);
+
+   makeKey(acKey, i);
+   return SymTable_put(oSymTable, acKey, &acValues[i]);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Remove key number i from oSymTable, and return what SymTable_remove
+   returns. */
+
+static void *removeKey(SymTable_T oSymTable, int i)
+{
+   char acKey[MAX_KEY_LENGTH];
+
+   assert(oSymTable != NULL);
+
+   makeKey(acKey, i);
+   return SymTable_remove(oSymTable, acKey);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test lookups on an incremental table while its resizes are only
+   partly done. Every put may start a resize, and each later call
+   moves only a few buckets, so the checks after each put look up
+   bindings on both sides of the migration. */
+
+static void testIncrementalLookups(void)
+{
+   enum {KEY_COUNT = 20000};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing lookups during an incremental resize.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      ASSURE(putKey(oSymTable, i));
+      ASSURE(! putKey(oSymTable, i));
+      ASSURE(holdsKey(oSymTable, i));
+      ASSURE(holdsKey(oSymTable, i / 2));
+      ASSURE(holdsKey(oSymTable, i / 3));
+      makeKey(acKey, i + 1);
+      ASSURE(! SymTable_contains(oSymTable, acKey));
+      ASSURE(SymTable_get(oSymTable, acKey) == NULL);
+   }
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+
+   /* A replace in the middle of a resize changes the one binding */
+   for (i = 0; i < KEY_COUNT; i += 7)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_replace(oSymTable, acKey, &acValues[i + 1])
+         == &acValues[i]);
+      ASSURE(SymTable_get(oSymTable, acKey) == &acValues[i + 1]);
+      ASSURE(SymTable_replace(oSymTable, acKey, &acValues[i])
+         == &acValues[i + 1]);
+   }
+
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test removes on an incremental table while its resizes are only
+   partly done. Each step puts a new key, which keeps the table
+   growing, and removes an old one, which may sit in either bucket
+   array. */
+
+static void testIncrementalRemoves(void)
+{
+   enum {KEY_COUNT = 15000};
+
+   SymTable_T oSymTable;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing removes during an incremental resize.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      ASSURE(putKey(oSymTable, KEY_COUNT + i));
+      ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+      ASSURE(removeKey(oSymTable, i) == NULL);
+      ASSURE(! holdsKey(oSymTable, i));
+      ASSURE(holdsKey(oSymTable, KEY_COUNT + i));
+      ASSURE(holdsKey(oSymTable, KEY_COUNT + i / 2));
+      if (i + 1 < KEY_COUNT)
+         ASSURE(holdsKey(oSymTable, i + 1));
+      ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+   }
+
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(removeKey(oSymTable, KEY_COUNT + i)
+         == &acValues[KEY_COUNT + i]);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a table made by pfNew as it shrinks on its own while bindings
+   are removed, and grows again. */
+
+static void testShrink(SymTable_T (*pfNew)(void))
+{
+   enum {KEY_COUNT = 20000};
+   enum {KEYS_KEPT = 10};
+
+   SymTable_T oSymTable;
+   int i;
+
+   assert(pfNew != NULL);
+
+   oSymTable = (*pfNew)();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+
+   /* Remove from the front, checking the rest as the table shrinks */
+   for (i = 0; i < KEY_COUNT - KEYS_KEPT; i++)
+   {
+      ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+      ASSURE(holdsKey(oSymTable, i + 1));
+      ASSURE(holdsKey(oSymTable, i + 1 + (KEY_COUNT - 2 - i) / 2));
+   }
+   ASSURE(SymTable_getLength(oSymTable) == KEYS_KEPT);
+   for (i = KEY_COUNT - KEYS_KEPT; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+
+   /* And grow back */
+   for (i = 0; i < KEY_COUNT - KEYS_KEPT; i++)
+      ASSURE(putKey(oSymTable, i));
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that a table made by SymTable_new that was grown to
+   GROWN_BINDINGS bindings shrinks on its own, one step at a time, as
+   its bindings are removed, and that after each shrink it stays the
+   same size while BATCH_SIZE bindings come and go. */
+
+static void testShrinkHysteresis(void)
+{
+   enum {GROWN_BINDINGS = 4000};
+   enum {BATCH_SIZE = 8};
+   enum {CYCLE_COUNT = 100};
+
+   SymTable_T oSymTable;
+   size_t uBuckets;
+   size_t uShrunk;
+   int iShrinks = 0;
+   int iCycle;
+   int iBindings;
+   int i;
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < GROWN_BINDINGS; i++)
+      ASSURE(putKey(oSymTable, i));
+   uBuckets = SymTable_getBucketCount(oSymTable);
+   ASSURE(uBuckets >= GROWN_BINDINGS / 2);
+
+   /* Remove from the back, so that the keys from iBindings on are
+      free for the rounds of puts */
+   for (iBindings = GROWN_BINDINGS - 1; iBindings >= 0; iBindings--)
+   {
+      ASSURE(removeKey(oSymTable, iBindings) == &acValues[iBindings]);
+      uShrunk = SymTable_getBucketCount(oSymTable);
+      if (uShrunk == uBuckets)
+         continue;
+
+      /* A shrink leaves the table at most half loaded, with room for
+         a batch of puts before it must grow again */
+      iShrinks++;
+      ASSURE(uShrunk < uBuckets);
+      ASSURE((size_t)(2 * iBindings) <= uShrunk);
+      ASSURE((size_t)(iBindings + BATCH_SIZE) <= uShrunk);
+
+      for (iCycle = 0; iCycle < CYCLE_COUNT; iCycle++)
+      {
+         for (i = iBindings; i < iBindings + BATCH_SIZE; i++)
+         {
+            ASSURE(putKey(oSymTable, i));
+            ASSURE(SymTable_getBucketCount(oSymTable) == uShrunk);
+         }
+         for (i = iBindings; i < iBindings + BATCH_SIZE; i++)
+         {
+            ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+            ASSURE(SymTable_getBucketCount(oSymTable) == uShrunk);
+         }
+      }
+      ASSURE(SymTable_getLength(oSymTable) == (size_t)iBindings);
+      uBuckets = uShrunk;
+   }
+
+   /* The table shrank at least once, but not below its starting
+      size */
+   ASSURE(iShrinks > 0);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(SymTable_getBucketCount(oSymTable) >= 509);
+   for (i = 0; i < GROWN_BINDINGS; i++)
+      ASSURE(! holdsKey(oSymTable, i));
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test automatic shrinking, and that a table that has just shrunk
+   does not grow and shrink again as a few bindings come and go. */
+
+static void testAutomaticShrink(void)
+{
+   printf("------------------------------------------------------\n");
+   printf("Testing automatic shrinking.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   testShrink(SymTable_new);
+   testShrink(SymTable_newIncremental);
+   testShrink(SymTable_newArena);
+   testShrinkHysteresis();
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_shrinkToFit on empty, small, large and incremental
+   tables. */
+
+static void testShrinkToFit(void)
+{
+   enum {KEY_COUNT = 30000};
+   enum {KEYS_KEPT = 100};
+
+   SymTable_T oSymTable;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_shrinkToFit.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* An empty table, and a table still small enough for one chain */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   SymTable_shrinkToFit(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(SymTable_getBucketCount(oSymTable) == 1);
+   for (i = 0; i < 5; i++)
+      ASSURE(putKey(oSymTable, i));
+   SymTable_shrinkToFit(oSymTable);
+   for (i = 0; i < 5; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   SymTable_free(oSymTable);
+
+   /* A bulk delete, then shrinkToFit, then more puts */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+   for (i = KEYS_KEPT; i < KEY_COUNT; i++)
+      ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+   SymTable_shrinkToFit(oSymTable);
+   ASSURE(SymTable_getLength(oSymTable) == KEYS_KEPT);
+   ASSURE(SymTable_getBucketCount(oSymTable) == 509);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i) == (i < KEYS_KEPT));
+   SymTable_shrinkToFit(oSymTable);
+   for (i = KEYS_KEPT; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   SymTable_free(oSymTable);
+
+   /* An incremental table, called while a resize is partly done */
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      ASSURE(putKey(oSymTable, i));
+      if (i % 1000 == 999)
+         SymTable_shrinkToFit(oSymTable);
+   }
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   for (i = 0; i < KEY_COUNT; i += 2)
+      ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+   SymTable_shrinkToFit(oSymTable);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i) == (i % 2 == 1));
+   ASSURE(SymTable_getLength(oSymTable) == KEY_COUNT / 2);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_Key tokens, which carry a SymTable_hashFast code, on a
+   table made by SymTable_newWithHash, which must hash them again. */
+
+static void testKeyTokensWithHash(void)
+{
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   SymTable_Key sKey;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_Key tokens with the table's own hash.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newWithHash(SymTable_hashLegacy, NULL);
+   ASSURE(oSymTable != NULL);
+
+   for (i = 0; i < MAX_KEYS; i++)
+   {
+      makeKey(acKey, i);
+      if (i % 2 == 0)
+         ASSURE(SymTable_putK(oSymTable, SymTable_makeKey(acKey),
+            &acValues[i]));
+      else
+         ASSURE(putKey(oSymTable, i));
+   }
+   for (i = 0; i < MAX_KEYS; i++)
+   {
+      makeKey(acKey, i);
+      sKey = SymTable_makeKey(acKey);
+      ASSURE(holdsKey(oSymTable, i));
+      ASSURE(SymTable_getK(oSymTable, sKey) == &acValues[i]);
+      if (i % 3 == 0)
+         ASSURE(SymTable_removeK(oSymTable, sKey) == &acValues[i]);
+   }
+   for (i = 0; i < MAX_KEYS; i++)
+      ASSURE(holdsKey(oSymTable, i) == (i % 3 != 0));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_getMany with batches that mix hits and misses, on an
+   incremental table whose resizes are partly done. */
+
+static void testGetMany(void)
+{
+   enum {KEY_COUNT = 20000};
+   enum {BATCH_SIZE = 37};
+
+   static char aacKeys[BATCH_SIZE][MAX_KEY_LENGTH];
+   const char *apcKeys[BATCH_SIZE];
+   void *apvValues[BATCH_SIZE];
+   SymTable_T oSymTable;
+   size_t uExpected;
+   int aiKeys[BATCH_SIZE];
+   int iPut;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_getMany.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+
+   ASSURE(SymTable_getMany(oSymTable, NULL, 0, NULL) == 0);
+
+   /* After each put, look up a batch of put and not yet put keys */
+   for (iPut = 0; iPut < KEY_COUNT; iPut++)
+   {
+      ASSURE(putKey(oSymTable, iPut));
+      if (iPut % 5 != 0)
+         continue;
+
+      uExpected = 0;
+      for (i = 0; i < BATCH_SIZE; i++)
+      {
+         /* Spread over [0, 2 * iPut], with one key asked for twice */
+         aiKeys[i] = (int)(((long)i * 7919 + iPut) % (2L * iPut + 1));
+         if (i == BATCH_SIZE - 1)
+            aiKeys[i] = aiKeys[0];
+         makeKey(aacKeys[i], aiKeys[i]);
+         apcKeys[i] = aacKeys[i];
+         apvValues[i] = &acValues[0];
+         if (aiKeys[i] <= iPut)
+            uExpected++;
+      }
+
+      ASSURE(SymTable_getMany(oSymTable, apcKeys, BATCH_SIZE, apvValues)
+         == uExpected);
+      for (i = 0; i < BATCH_SIZE; i++)
+         ASSURE(apvValues[i] == (aiKeys[i] <= iPut ?
+            (void*)&acValues[aiKeys[i]] : NULL));
+   }
+
+   /* Removed keys are misses */
+   for (i = 0; i < BATCH_SIZE; i++)
+   {
+      makeKey(aacKeys[i], i);
+      apcKeys[i] = aacKeys[i];
+      if (i % 2 == 0)
+         ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+   }
+   ASSURE(SymTable_getMany(oSymTable, apcKeys, BATCH_SIZE, apvValues)
+      == BATCH_SIZE / 2);
+   for (i = 0; i < BATCH_SIZE; i++)
+      ASSURE(apvValues[i] == (i % 2 == 0 ? NULL : (void*)&acValues[i]));
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The most threads testMapParallel uses */
+enum {MAX_MAP_THREADS = 8};
+
+/* A MapVisits records what one thread of SymTable_mapParallel saw. */
+
+struct MapVisits
+{
+   /* The number of bindings the thread visited */
+   size_t uCount;
+
+   /* The number of visits that had a key and value that do not belong
+      together */
+   size_t uMismatches;
+
+   /* The number of times the thread visited key number i */
+   unsigned char aucVisits[MAX_KEYS];
+};
+
+static struct MapVisits asMapVisits[MAX_MAP_THREADS];
+
+/*--------------------------------------------------------------------*/
+
+/* Record a visit of the binding of pcKey to pvValue in the MapVisits
+   at pvExtra. */
+
+static void recordVisit(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   struct MapVisits *psVisits = (struct MapVisits*)pvExtra;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   psVisits->uCount++;
+   i = (int)((char*)pvValue - acValues);
+   if (i < 0 || i >= MAX_KEYS)
+   {
+      psVisits->uMismatches++;
+      return;
+   }
+   makeKey(acKey, i);
+   if (strcmp(acKey, pcKey) != 0)
+      psVisits->uMismatches++;
+   if (psVisits->aucVisits[i] < 255)
+      psVisits->aucVisits[i]++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Map over oSymTable, which binds keys 0 to iKeyCount-1, with uThreads
+   threads, and check that each binding was visited exactly once. */
+
+static void checkMapParallel(SymTable_T oSymTable, int iKeyCount,
+   size_t uThreads)
+{
+   void *apvExtra[MAX_MAP_THREADS];
+   size_t uTotal = 0;
+   size_t uThread;
+   int iVisits;
+   int i;
+
+   assert(uThreads > 0 && uThreads <= MAX_MAP_THREADS);
+
+   memset(asMapVisits, 0, sizeof(asMapVisits));
+   for (uThread = 0; uThread < uThreads; uThread++)
+      apvExtra[uThread] = &asMapVisits[uThread];
+
+   SymTable_mapParallel(oSymTable, recordVisit, apvExtra, uThreads);
+
+   for (uThread = 0; uThread < uThreads; uThread++)
+   {
+      uTotal += asMapVisits[uThread].uCount;
+      ASSURE(asMapVisits[uThread].uMismatches == 0);
+   }
+   ASSURE(uTotal == (size_t)iKeyCount);
+   for (uThread = uThreads; uThread < MAX_MAP_THREADS; uThread++)
+      ASSURE(asMapVisits[uThread].uCount == 0);
+
+   for (i = 0; i < MAX_KEYS; i++)
+   {
+      iVisits = 0;
+      for (uThread = 0; uThread < uThreads; uThread++)
+         iVisits += asMapVisits[uThread].aucVisits[i];
+      ASSURE(iVisits == (i < iKeyCount ? 1 : 0));
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_mapParallel on empty, small and large tables, and on
+   an incremental table in the middle of a resize, with one thread
+   and with several. */
+
+static void testMapParallel(void)
+{
+   enum {KEY_COUNT = 30000};
+
+   SymTable_T oSymTable;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_mapParallel.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   checkMapParallel(oSymTable, 0, 4);
+   for (i = 0; i < 5; i++)
+      ASSURE(putKey(oSymTable, i));
+   checkMapParallel(oSymTable, 5, 1);
+   checkMapParallel(oSymTable, 5, MAX_MAP_THREADS);
+   for (i = 5; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+   checkMapParallel(oSymTable, KEY_COUNT, 1);
+   checkMapParallel(oSymTable, KEY_COUNT, 3);
+   checkMapParallel(oSymTable, KEY_COUNT, MAX_MAP_THREADS);
+   SymTable_free(oSymTable);
+
+   /* Stop at several points of the incremental resizes, so that some
+      bindings are still in the old buckets */
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      ASSURE(putKey(oSymTable, i));
+      if (i % 2503 == 0)
+         checkMapParallel(oSymTable, i + 1, 4);
+   }
+   checkMapParallel(oSymTable, KEY_COUNT, 4);
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test tables made by SymTable_newParallelResize. They must hold the
+   same bindings as any other table once their resizes, which past
+   100000 bindings are split among the threads, are done. */
+
+static void testParallelResize(void)
+{
+   enum {KEY_COUNT = MAX_KEYS};
+
+   SymTable_T oSymTable;
+   size_t uThreads;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_newParallelResize.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (uThreads = 1; uThreads <= 4; uThreads += 3)
+   {
+      oSymTable = SymTable_newParallelResize(uThreads);
+      ASSURE(oSymTable != NULL);
+
+      for (i = 0; i < KEY_COUNT; i++)
+         ASSURE(putKey(oSymTable, i));
+      ASSURE(SymTable_getLength(oSymTable) == (size_t)KEY_COUNT);
+      for (i = 0; i < KEY_COUNT; i++)
+         ASSURE(holdsKey(oSymTable, i));
+      ASSURE(! SymTable_contains(oSymTable, "key-1"));
+      checkMapParallel(oSymTable, KEY_COUNT, 4);
+
+      /* Putting them again must find every one of them */
+      for (i = 0; i < KEY_COUNT; i += 7)
+         ASSURE(! putKey(oSymTable, i));
+
+      for (i = KEY_COUNT - 1; i >= 0; i--)
+         ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+      ASSURE(SymTable_getLength(oSymTable) == 0);
+      ASSURE(! holdsKey(oSymTable, 0));
+
+      SymTable_free(oSymTable);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test a cursor that removes each binding as it is returned, on
+   incremental tables opened in the middle of a resize. Without the
+   cursor the removals would shrink the table and relink the bindings
+   it has yet to return. */
+
+static void testIterRemoveIncremental(void)
+{
+   enum {KEY_COUNT = 20000};
+
+   static char acVisits[KEY_COUNT];
+   SymTable_T oSymTable;
+   SymTable_Iter sIter;
+   const char *pcKey;
+   void *pvValue;
+   int iKeyCount;
+   int iVisited;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing removal through a cursor on incremental tables.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   /* Each count is just past a resize, which is still moving buckets */
+   for (iKeyCount = 1020; iKeyCount <= KEY_COUNT; iKeyCount *= 4)
+   {
+      oSymTable = SymTable_newIncremental();
+      ASSURE(oSymTable != NULL);
+      for (i = 0; i < iKeyCount; i++)
+         ASSURE(putKey(oSymTable, i));
+
+      memset(acVisits, 0, sizeof(acVisits));
+      iVisited = 0;
+      SymTable_iterBegin(oSymTable, &sIter);
+      while (SymTable_iterNext(&sIter, &pcKey, &pvValue))
+      {
+         i = (int)((char*)pvValue - acValues);
+         ASSURE(i >= 0 && i < iKeyCount);
+         acVisits[i]++;
+         iVisited++;
+         ASSURE(SymTable_remove(oSymTable, pcKey) == pvValue);
+      }
+      SymTable_iterEnd(&sIter);
+
+      ASSURE(iVisited == iKeyCount);
+      for (i = 0; i < iKeyCount; i++)
+         ASSURE(acVisits[i] == 1);
+      ASSURE(SymTable_getLength(oSymTable) == 0);
+      ASSURE(putKey(oSymTable, 0));
+      ASSURE(holdsKey(oSymTable, 0));
+
+      SymTable_free(oSymTable);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_newWithCapacity and SymTable_reserve: a sized table
+   holds what it was sized for, sizing a table that already has
+   bindings keeps them, and sizes that no table could reach fail
+   without harm. */
+
+static void testPresize(void)
+{
+   enum {KEY_COUNT = 20000};
+
+   SymTable_T oSymTable;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_newWithCapacity and SymTable_reserve.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newWithCapacity(0);
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_getLength(oSymTable) == 0);
+   ASSURE(putKey(oSymTable, 0));
+   ASSURE(holdsKey(oSymTable, 0));
+   SymTable_free(oSymTable);
+
+   oSymTable = SymTable_newWithCapacity(KEY_COUNT);
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+
+   /* Removals keep the size, and the table keeps working */
+   for (i = 0; i < KEY_COUNT; i += 2)
+      ASSURE(removeKey(oSymTable, i) == &acValues[i]);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i) == (i % 2 == 1));
+   SymTable_free(oSymTable);
+
+   /* Reserve on an incremental table in the middle of a resize */
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < 1020; i++)
+      ASSURE(putKey(oSymTable, i));
+   ASSURE(SymTable_reserve(oSymTable, KEY_COUNT));
+   ASSURE(SymTable_reserve(oSymTable, 10));
+   for (i = 0; i < 1020; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   for (i = 1020; i < KEY_COUNT; i++)
+      ASSURE(putKey(oSymTable, i));
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+
+   /* Sizes that could never be allocated */
+   ASSURE(SymTable_reserve(oSymTable, (size_t)-1) == 0);
+   ASSURE(SymTable_reserve(oSymTable, (size_t)-1 / 2) == 0);
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   SymTable_free(oSymTable);
+
+   ASSURE(SymTable_newWithCapacity((size_t)-1) == NULL);
+   ASSURE(SymTable_newWithCapacity((size_t)-1 / 2) == NULL);
+   ASSURE(SymTable_newWithCapacity((size_t)-1 / 64) == NULL);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* The file that testFreeze writes its images to */
+static const char acImagePath[] = "testsymtablehashapi.img";
+
+/* Return the size of the value at pvValue, one of the acValues. */
+
+static size_t valueSize(const void *pvValue)
+{
+   assert(pvValue != NULL);
+
+   return 1;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return 0, the size of the value at pvValue, which has no bytes. */
+
+static size_t emptyValueSize(const void *pvValue)
+{
+   assert(pvValue != NULL);
+
+   return 0;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Count in the int at pvExtra a visit of the binding of pcKey to
+   pvValue, after checking that pvValue holds the byte that key's
+   value held when it was frozen, or is NULL for key 0. */
+
+static void countFrozenVisit(const char *pcKey, void *pvValue,
+   void *pvExtra)
+{
+   int i;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   ASSURE(sscanf(pcKey, "key%d", &i) == 1);
+   ASSURE(i >= 0 && i < MAX_KEYS);
+   if (i == 0)
+      ASSURE(pvValue == NULL);
+   else
+      ASSURE(pvValue != NULL && *(char*)pvValue == acValues[i]);
+   (*(int*)pvExtra)++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Write the uSize bytes at pucImage to acImagePath. Return 1 (TRUE)
+   on success and 0 (FALSE) otherwise. */
+
+static int writeImage(const unsigned char *pucImage, size_t uSize)
+{
+   FILE *psFile;
+   int iSuccessful;
+
+   assert(pucImage != NULL);
+
+   psFile = fopen(acImagePath, "wb");
+   if (psFile == NULL)
+      return 0;
+   iSuccessful = fwrite(pucImage, 1, uSize, psFile) == uSize;
+   return fclose(psFile) == 0 && iSuccessful;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the frozen binding of key number i in oSymTable, after
+   checking that SymTable_contains and the length-delimited lookups
+   agree with SymTable_get. */
+
+static void *getFrozen(SymTable_T oSymTable, int i)
+{
+   char acKey[MAX_KEY_LENGTH];
+   void *pvValue;
+
+   assert(oSymTable != NULL);
+
+   makeKey(acKey, i);
+   pvValue = SymTable_get(oSymTable, acKey);
+   ASSURE(SymTable_getN(oSymTable, acKey, strlen(acKey)) == pvValue);
+   if (pvValue != NULL)
+   {
+      ASSURE(SymTable_contains(oSymTable, acKey));
+      ASSURE(SymTable_containsN(oSymTable, acKey, strlen(acKey)));
+   }
+   return pvValue;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_freeze and SymTable_openFrozen: an image of an
+   incremental table in the middle of a resize answers every lookup
+   that the table did, and damaged images are rejected when opened or
+   have their damaged entries skipped, without reading outside the
+   file. The damaged images are written by hand, so this test knows
+   the image layout: a header of 8 magic bytes and 4 size_t fields,
+   then slots of 2 size_t fields with the entry offset second, then
+   entries of 2 size_t fields (key length, value offset) and the
+   key. */
+
+static void testFreeze(void)
+{
+   enum {KEY_COUNT = 3000};
+   enum {HEADER_SIZE = 8 + 4 * sizeof(size_t)};
+   enum {SLOT_SIZE = 2 * sizeof(size_t)};
+
+   SymTable_T oSymTable;
+   SymTable_T oFrozen;
+   unsigned char *pucImage;
+   unsigned char *pucCopy;
+   char acKey[MAX_KEY_LENGTH];
+   FILE *psFile;
+   void *pvValue;
+   long lSize;
+   size_t uSize;
+   size_t uNumSlots;
+   size_t uOffset;
+   size_t u;
+   int iVisits;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_freeze and SymTable_openFrozen.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   for (i = 0; i < KEY_COUNT; i++)
+      acValues[i] = (char)(i % 100 + 1);
+
+   /* An empty table */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_freeze(oSymTable, acImagePath, valueSize));
+   SymTable_free(oSymTable);
+   oFrozen = SymTable_openFrozen(acImagePath);
+   ASSURE(oFrozen != NULL);
+   if (oFrozen != NULL)
+   {
+      ASSURE(SymTable_getLength(oFrozen) == 0);
+      ASSURE(getFrozen(oFrozen, 0) == NULL);
+      SymTable_free(oFrozen);
+   }
+
+   /* Values of no bytes, the last of which ends the image */
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_put(oSymTable, "a", &acValues[1]));
+   ASSURE(SymTable_put(oSymTable, "b", &acValues[2]));
+   ASSURE(SymTable_freeze(oSymTable, acImagePath, emptyValueSize));
+   SymTable_free(oSymTable);
+   oFrozen = SymTable_openFrozen(acImagePath);
+   ASSURE(oFrozen != NULL);
+   if (oFrozen != NULL)
+   {
+      ASSURE(SymTable_getLength(oFrozen) == 2);
+      ASSURE(SymTable_contains(oFrozen, "a"));
+      ASSURE(SymTable_contains(oFrozen, "b"));
+      ASSURE(SymTable_get(oFrozen, "a") != NULL);
+      ASSURE(SymTable_get(oFrozen, "b") != NULL);
+      SymTable_free(oFrozen);
+   }
+
+   /* Key 0 is bound to NULL; the rest to their values */
+   oSymTable = SymTable_newIncremental();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_put(oSymTable, acKey,
+         i == 0 ? NULL : &acValues[i]));
+   }
+   ASSURE(SymTable_freeze(oSymTable, acImagePath, valueSize));
+
+   /* Freezing leaves the bindings as they were */
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)KEY_COUNT);
+   for (i = 1; i < KEY_COUNT; i++)
+      ASSURE(holdsKey(oSymTable, i));
+   SymTable_free(oSymTable);
+
+   oFrozen = SymTable_openFrozen(acImagePath);
+   ASSURE(oFrozen != NULL);
+   if (oFrozen == NULL)
+      return;
+   ASSURE(SymTable_getLength(oFrozen) == (size_t)KEY_COUNT);
+   ASSURE(getFrozen(oFrozen, 0) == NULL);
+   ASSURE(SymTable_contains(oFrozen, "key0"));
+   for (i = 1; i < KEY_COUNT; i++)
+   {
+      pvValue = getFrozen(oFrozen, i);
+      ASSURE(pvValue != NULL && *(char*)pvValue == acValues[i]);
+   }
+   ASSURE(getFrozen(oFrozen, KEY_COUNT) == NULL);
+   ASSURE(! SymTable_contains(oFrozen, "key"));
+   ASSURE(SymTable_containsN(oFrozen, "key10", 4));
+   ASSURE(! SymTable_containsN(oFrozen, "key1", 3));
+   SymTable_free(oFrozen);
+
+   /* Read the image back to make damaged copies of it */
+   psFile = fopen(acImagePath, "rb");
+   ASSURE(psFile != NULL);
+   if (psFile == NULL)
+      return;
+   fseek(psFile, 0, SEEK_END);
+   lSize = ftell(psFile);
+   rewind(psFile);
+   ASSURE(lSize > (long)HEADER_SIZE);
+   uSize = (size_t)lSize;
+   pucImage = (unsigned char*)malloc(uSize);
+   pucCopy = (unsigned char*)malloc(uSize);
+   ASSURE(pucImage != NULL && pucCopy != NULL);
+   if (pucImage == NULL || pucCopy == NULL ||
+       fread(pucImage, 1, uSize, psFile) != uSize)
+   {
+      fclose(psFile);
+      free(pucImage);
+      free(pucCopy);
+      return;
+   }
+   fclose(psFile);
+   memcpy(&uNumSlots, pucImage + 8 + 2 * sizeof(size_t), sizeof(size_t));
+
+   /* Images whose header does not fit the file are rejected */
+   ASSURE(writeImage(pucImage, HEADER_SIZE - 1));
+   ASSURE(SymTable_openFrozen(acImagePath) == NULL);
+   ASSURE(writeImage(pucImage, uSize / 2));
+   ASSURE(SymTable_openFrozen(acImagePath) == NULL);
+   memcpy(pucCopy, pucImage, uSize);
+   pucCopy[0] ^= 1;
+   ASSURE(writeImage(pucCopy, uSize));
+   ASSURE(SymTable_openFrozen(acImagePath) == NULL);
+   ASSURE(SymTable_openFrozen("testsymtablehashapi.none") == NULL);
+
+   /* Point every slot past the end of the file, or at the last bytes
+      of the file, where there is no room for a key. No slot is left
+      empty, so a lookup that missed would never stop probing. */
+   for (i = 0; i < 2; i++)
+   {
+      memcpy(pucCopy, pucImage, uSize);
+      uOffset = i == 0 ? uSize * 2 : uSize - 2 * sizeof(size_t);
+      for (u = 0; u < uNumSlots; u++)
+         memcpy(pucCopy + HEADER_SIZE + u * SLOT_SIZE + sizeof(size_t),
+            &uOffset, sizeof(size_t));
+      ASSURE(writeImage(pucCopy, uSize));
+      oFrozen = SymTable_openFrozen(acImagePath);
+      ASSURE(oFrozen != NULL);
+      if (oFrozen == NULL)
+         continue;
+      ASSURE(getFrozen(oFrozen, 1) == NULL);
+      ASSURE(getFrozen(oFrozen, KEY_COUNT) == NULL);
+      iVisits = 0;
+      SymTable_map(oFrozen, countFrozenVisit, &iVisits);
+      ASSURE(iVisits == 0);
+      SymTable_free(oFrozen);
+   }
+
+   /* Give key 17 a huge length and key 18 a value past the end of the
+      file; only those two are lost */
+   memcpy(pucCopy, pucImage, uSize);
+   for (uOffset = 0; uOffset + 8 <= uSize; uOffset++)
+   {
+      if (memcmp(pucCopy + uOffset, "key17", 6) == 0 &&
+          uOffset >= 2 * sizeof(size_t))
+         memset(pucCopy + uOffset - 2 * sizeof(size_t), 0xFF,
+            sizeof(size_t));
+      if (memcmp(pucCopy + uOffset, "key18", 6) == 0 &&
+          uOffset >= sizeof(size_t))
+         memset(pucCopy + uOffset - sizeof(size_t), 0xFF,
+            sizeof(size_t));
+   }
+   ASSURE(writeImage(pucCopy, uSize));
+   oFrozen = SymTable_openFrozen(acImagePath);
+   ASSURE(oFrozen != NULL);
+   if (oFrozen != NULL)
+   {
+      ASSURE(getFrozen(oFrozen, 17) == NULL);
+      ASSURE(getFrozen(oFrozen, 18) == NULL);
+      ASSURE(getFrozen(oFrozen, 19) != NULL);
+      iVisits = 0;
+      SymTable_map(oFrozen, countFrozenVisit, &iVisits);
+      ASSURE(iVisits == KEY_COUNT - 2);
+      SymTable_free(oFrozen);
+   }
+
+   free(pucImage);
+   free(pucCopy);
+   remove(acImagePath);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the functions that only the hash table implementation provides.
+   The command-line arguments are ignored. Return 0. */
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+
+   testIncrementalLookups();
+   testIncrementalRemoves();
+   testAutomaticShrink();
+   testShrinkToFit();
+   testKeyTokensWithHash();
+   testGetMany();
+   testMapParallel();
+   testParallelResize();
+   testIterRemoveIncremental();
+   testPresize();
+   testFreeze();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,105 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablekeys.c                                                 */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtablekeys.c, builds the key set, kept in key     */
+/* order, that the clients testing ordered visits share.              */
+/*--------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "testsymtablekeys.h"
+
+/*--------------------------------------------------------------------*/
+
+char aacKeys[MAX_SET_KEYS][MAX_SET_KEY_LENGTH];
+int iKeyCount;
+int aiSorted[MAX_SET_KEYS];
+
+/*--------------------------------------------------------------------*/
+
+/* Add the key pcKey to aacKeys. */
+
+static void addKey(const char *pcKey)
+{
+   assert(pcKey != NULL);
+   assert(iKeyCount < MAX_SET_KEYS);
+   assert(strlen(pcKey) < MAX_SET_KEY_LENGTH);
+
+   strcpy(aacKeys[iKeyCount], pcKey);
+   iKeyCount++;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the strcmp order of the keys whose numbers are at pv1 and
+   pv2. */
+
+static int compareKeyNumbers(const void *pv1, const void *pv2)
+{
+   return strcmp(aacKeys[*(const int*)pv1], aacKeys[*(const int*)pv2]);
+}
+
+/*--------------------------------------------------------------------*/
+
+void makeKeys(void)
+{
+   char acKey[MAX_SET_KEY_LENGTH];
+   int iLength;
+   int iBits;
+   int i;
+
+   iKeyCount = 0;
+   addKey("");
+
+   for (iLength = 1; iLength <= 6; iLength++)
+      for (iBits = 0; iBits < (1 << iLength); iBits++)
+      {
+         for (i = 0; i < iLength; i++)
+            acKey[i] = (char)((iBits >> i) & 1 ? 'b' : 'a');
+         acKey[iLength] = '\0';
+         addKey(acKey);
+      }
+
+   memset(acKey, 'x', LONG_PREFIX_LENGTH);
+   acKey[LONG_PREFIX_LENGTH] = '\0';
+   addKey(acKey);
+   for (i = 0; i < 100; i++)
+   {
+      sprintf(acKey + LONG_PREFIX_LENGTH, "%d", i);
+      addKey(acKey);
+   }
+   acKey[LONG_PREFIX_LENGTH - 1] = '\0';
+   addKey(acKey);
+
+   for (i = 0; i < 1000; i++)
+   {
+      sprintf(acKey, "key%d", i);
+      addKey(acKey);
+   }
+
+   for (i = 0; i < iKeyCount; i++)
+      aiSorted[i] = i;
+   qsort(aiSorted, (size_t)iKeyCount, sizeof(int), compareKeyNumbers);
+}
+
+/*--------------------------------------------------------------------*/
+
+void recordVisit(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   struct Visits *psVisits = (struct Visits*)pvExtra;
+   int i;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   i = (int)((char*)pvValue - acValues);
+   if (i < 0 || i >= iKeyCount || strcmp(pcKey, aacKeys[i]) != 0 ||
+       psVisits->iCount == MAX_SET_KEYS)
+   {
+      psVisits->iMismatches++;
+      return;
+   }
+   psVisits->aiKeys[psVisits->iCount++] = i;
+}
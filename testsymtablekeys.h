@@ -0,0 +1,63 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablekeys.h                                                 */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtablekeys.h, declares the key set, kept in key   */
+/* order, that the clients testing ordered visits share.              */
+/*--------------------------------------------------------------------*/
+
+#ifndef TestSymTableKeys_INCLUDED
+#define TestSymTableKeys_INCLUDED
+
+#include "testsymtableutil.h"
+
+/* The largest number of keys in the key set */
+enum {MAX_SET_KEYS = 2000};
+
+/* The maximum length of a key in the key set, including its '\0' */
+enum {MAX_SET_KEY_LENGTH = 256};
+
+/* The length of the prefix that the long keys share */
+enum {LONG_PREFIX_LENGTH = 200};
+
+/* Key number i is aacKeys[i], and its value is &acValues[i] */
+extern char aacKeys[MAX_SET_KEYS][MAX_SET_KEY_LENGTH];
+extern int iKeyCount;
+
+/* The key numbers in ascending key order */
+extern int aiSorted[MAX_SET_KEYS];
+
+/*--------------------------------------------------------------------*/
+
+/* A Visits records the bindings that a map function visited. */
+
+struct Visits
+{
+   /* The key numbers, in the order visited */
+   int aiKeys[MAX_SET_KEYS];
+
+   /* The number of bindings visited */
+   int iCount;
+
+   /* The number of visits whose key and value do not belong
+      together */
+   int iMismatches;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Fill aacKeys with distinct keys that make ordered visits hard to get
+   right: the empty key, every string of up to six 'a's and 'b's, so
+   that many keys are prefixes of one another, keys that share a long
+   prefix and differ only near their ends, and ordinary keys. Then fill
+   aiSorted. */
+
+void makeKeys(void);
+
+/*--------------------------------------------------------------------*/
+
+/* Record in the Visits at pvExtra a visit of the binding of pcKey to
+   pvValue. */
+
+void recordVisit(const char *pcKey, void *pvValue, void *pvExtra);
+
+#endif
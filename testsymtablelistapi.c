@@ -0,0 +1,257 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablelistapi.c                                              */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtablelistapi.c, tests the functions that only    */
+/* the linked list implementation of symtable.h provides.             */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include "testsymtableutil.h"
+
+/*--------------------------------------------------------------------*/
+
+/* The largest number of bindings whose visits are recorded */
+enum {MAX_VISITS = 2000};
+
+/*--------------------------------------------------------------------*/
+
+/* A Visits records the order in which SymTable_map visited the
+   bindings. */
+
+struct Visits
+{
+   /* The key numbers, in the order visited */
+   int aiKeys[MAX_VISITS];
+
+   /* The number of bindings visited */
+   int iCount;
+};
+
+/*--------------------------------------------------------------------*/
+
+/* Record in the Visits at pvExtra a visit of the binding of pcKey to
+   pvValue. */
+
+static void recordVisit(const char *pcKey, void *pvValue, void *pvExtra)
+{
+   struct Visits *psVisits = (struct Visits*)pvExtra;
+   char acKey[MAX_KEY_LENGTH];
+   int i;
+
+   assert(pcKey != NULL);
+   assert(pvExtra != NULL);
+
+   i = (int)((char*)pvValue - acValues);
+   ASSURE(i >= 0 && i < MAX_VISITS);
+   if (i < 0 || i >= MAX_VISITS || psVisits->iCount == MAX_VISITS)
+      return;
+   makeKey(acKey, i);
+   ASSURE(strcmp(pcKey, acKey) == 0);
+   psVisits->aiKeys[psVisits->iCount++] = i;
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Return the number of the key that SymTable_map visits first in
+   oSymTable, which must not be empty, after checking that it visits
+   each of the iKeyCount bindings once. */
+
+static int firstKey(SymTable_T oSymTable, int iKeyCount)
+{
+   static struct Visits sVisits;
+   static char acSeen[MAX_VISITS];
+   int i;
+
+   assert(oSymTable != NULL);
+   assert(iKeyCount > 0);
+
+   sVisits.iCount = 0;
+   SymTable_map(oSymTable, recordVisit, &sVisits);
+   ASSURE(sVisits.iCount == iKeyCount);
+
+   memset(acSeen, 0, sizeof(acSeen));
+   for (i = 0; i < sVisits.iCount; i++)
+   {
+      ASSURE(! acSeen[sVisits.aiKeys[i]]);
+      acSeen[sVisits.aiKeys[i]] = 1;
+   }
+   return sVisits.aiKeys[0];
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_newMoveToFront: every kind of lookup must give the
+   same results as in a plain list, and move the binding it finds to
+   the front, where SymTable_map visits it first. */
+
+static void testMoveToFront(void)
+{
+   enum {KEY_COUNT = 1000};
+
+   SymTable_T oSymTable;
+   char acKey[MAX_KEY_LENGTH];
+   int iInserted;
+   void **ppvValue;
+   int iKeyCount;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_newMoveToFront.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newMoveToFront();
+   ASSURE(oSymTable != NULL);
+   ASSURE(SymTable_get(oSymTable, "key0") == NULL);
+
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_put(oSymTable, acKey, &acValues[i]));
+   }
+   iKeyCount = KEY_COUNT;
+   ASSURE(firstKey(oSymTable, iKeyCount) == KEY_COUNT - 1);
+
+   /* Keys from the back of the list come to the front */
+   for (i = 0; i < KEY_COUNT; i += 7)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_get(oSymTable, acKey) == &acValues[i]);
+      ASSURE(firstKey(oSymTable, iKeyCount) == i);
+   }
+
+   makeKey(acKey, 500);
+   ASSURE(SymTable_contains(oSymTable, acKey));
+   ASSURE(firstKey(oSymTable, iKeyCount) == 500);
+
+   makeKey(acKey, 501);
+   ASSURE(SymTable_replace(oSymTable, acKey, &acValues[501]) ==
+      &acValues[501]);
+   ASSURE(firstKey(oSymTable, iKeyCount) == 501);
+
+   makeKey(acKey, 502);
+   ASSURE(SymTable_getN(oSymTable, acKey, strlen(acKey)) ==
+      &acValues[502]);
+   ASSURE(firstKey(oSymTable, iKeyCount) == 502);
+
+   makeKey(acKey, 503);
+   ASSURE(SymTable_containsN(oSymTable, acKey, strlen(acKey)));
+   ASSURE(firstKey(oSymTable, iKeyCount) == 503);
+
+   makeKey(acKey, 504);
+   ASSURE(SymTable_replaceN(oSymTable, acKey, strlen(acKey),
+      &acValues[504]) == &acValues[504]);
+   ASSURE(firstKey(oSymTable, iKeyCount) == 504);
+
+   makeKey(acKey, 505);
+   ppvValue = SymTable_getOrInsert(oSymTable, acKey, &iInserted);
+   ASSURE(ppvValue != NULL && ! iInserted && *ppvValue == &acValues[505]);
+   ASSURE(firstKey(oSymTable, iKeyCount) == 505);
+
+   /* A lookup that fails moves nothing */
+   ASSURE(SymTable_get(oSymTable, "absent") == NULL);
+   ASSURE(firstKey(oSymTable, iKeyCount) == 505);
+
+   /* Removing the front binding and bindings moved there leaves the
+      rest intact */
+   makeKey(acKey, 505);
+   ASSURE(SymTable_remove(oSymTable, acKey) == &acValues[505]);
+   iKeyCount--;
+   for (i = 0; i < KEY_COUNT; i += 7)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_remove(oSymTable, acKey) == &acValues[i]);
+      iKeyCount--;
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iKeyCount);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_get(oSymTable, acKey) ==
+         (i % 7 == 0 || i == 505 ? NULL : (void*)&acValues[i]));
+   }
+   ASSURE(firstKey(oSymTable, iKeyCount) == KEY_COUNT - 1);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test that lookups in a move-to-front table do not reorder it while
+   a cursor is open, so that the cursor still returns each binding
+   once, and that they reorder it again once the cursor is closed. */
+
+static void testMoveToFrontIterator(void)
+{
+   enum {KEY_COUNT = 500};
+
+   static char acVisits[KEY_COUNT];
+   SymTable_T oSymTable;
+   SymTable_Iter sIter;
+   char acKey[MAX_KEY_LENGTH];
+   const char *pcKey;
+   void *pvValue;
+   int iVisited = 0;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing lookups through a cursor on a move-to-front "
+      "table.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   oSymTable = SymTable_newMoveToFront();
+   ASSURE(oSymTable != NULL);
+   for (i = 0; i < KEY_COUNT; i++)
+   {
+      makeKey(acKey, i);
+      ASSURE(SymTable_put(oSymTable, acKey, &acValues[i]));
+   }
+
+   /* Look up the binding just returned and one far behind it */
+   memset(acVisits, 0, sizeof(acVisits));
+   SymTable_iterBegin(oSymTable, &sIter);
+   while (SymTable_iterNext(&sIter, &pcKey, &pvValue))
+   {
+      i = (int)((char*)pvValue - acValues);
+      ASSURE(i >= 0 && i < KEY_COUNT);
+      acVisits[i]++;
+      iVisited++;
+      ASSURE(SymTable_get(oSymTable, pcKey) == pvValue);
+      makeKey(acKey, i / 2);
+      ASSURE(SymTable_get(oSymTable, acKey) == &acValues[i / 2]);
+   }
+   SymTable_iterEnd(&sIter);
+
+   ASSURE(iVisited == KEY_COUNT);
+   for (i = 0; i < KEY_COUNT; i++)
+      ASSURE(acVisits[i] == 1);
+   ASSURE(firstKey(oSymTable, KEY_COUNT) == KEY_COUNT - 1);
+
+   makeKey(acKey, 0);
+   ASSURE(SymTable_get(oSymTable, acKey) == &acValues[0]);
+   ASSURE(firstKey(oSymTable, KEY_COUNT) == 0);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the functions that only the linked list implementation
+   provides. The command-line arguments are ignored. Return 0. */
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+
+   testMoveToFront();
+   testMoveToFrontIterator();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
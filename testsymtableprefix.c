@@ -0,0 +1,159 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableprefix.c                                               */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtableprefix.c, tests SymTable_mapPrefix, which   */
+/* only the radix tree implementation of symtable.h provides, against */
+/* a brute-force scan of a sorted copy of the keys.                   */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "testsymtablekeys.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Check that SymTable_mapPrefix(oSymTable, pcPrefix, ...) visits
+   exactly the keys of oSymTable that start with pcPrefix, in ascending
+   order. acPresent[i] is 1 if oSymTable holds key number i. */
+
+static void checkPrefix(SymTable_T oSymTable, const char acPresent[],
+   const char *pcPrefix)
+{
+   static struct Visits sVisits;
+   size_t uPrefixLength;
+   int iExpected = 0;
+   int iSorted;
+   int i;
+
+   assert(oSymTable != NULL);
+   assert(acPresent != NULL);
+   assert(pcPrefix != NULL);
+
+   sVisits.iCount = 0;
+   sVisits.iMismatches = 0;
+   SymTable_mapPrefix(oSymTable, pcPrefix, recordVisit, &sVisits);
+   ASSURE(sVisits.iMismatches == 0);
+
+   uPrefixLength = strlen(pcPrefix);
+   for (iSorted = 0; iSorted < iKeyCount; iSorted++)
+   {
+      i = aiSorted[iSorted];
+      if (! acPresent[i] ||
+          strncmp(aacKeys[i], pcPrefix, uPrefixLength) != 0)
+         continue;
+      if (iExpected >= sVisits.iCount ||
+          sVisits.aiKeys[iExpected] != i)
+      {
+         printf("Prefix %.20s differs at binding %d.\n", pcPrefix,
+            iExpected);
+         ASSURE(0);
+         return;
+      }
+      iExpected++;
+   }
+   ASSURE(sVisits.iCount == iExpected);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check every key, and strings that are not keys, as a prefix against
+   oSymTable. */
+
+static void checkPrefixes(SymTable_T oSymTable, const char acPresent[])
+{
+   static const char *apcPrefixes[] = {"", "a", "ab", "abababa",
+      "abc", "b", "bbbbbbb", "c", "k", "key", "key1", "key99",
+      "key9999", "kez", "x", "xx", "y", "\177"};
+   char acPrefix[MAX_SET_KEY_LENGTH];
+   size_t u;
+   int i;
+
+   assert(oSymTable != NULL);
+   assert(acPresent != NULL);
+
+   for (u = 0; u < sizeof(apcPrefixes) / sizeof(apcPrefixes[0]); u++)
+      checkPrefix(oSymTable, acPresent, apcPrefixes[u]);
+
+   /* Prefixes that stop inside, at the end of, and past the long
+      prefix that many keys share */
+   memset(acPrefix, 'x', LONG_PREFIX_LENGTH + 1);
+   acPrefix[LONG_PREFIX_LENGTH + 1] = '\0';
+   checkPrefix(oSymTable, acPresent, acPrefix);
+   acPrefix[LONG_PREFIX_LENGTH] = '\0';
+   checkPrefix(oSymTable, acPresent, acPrefix);
+   strcpy(acPrefix + LONG_PREFIX_LENGTH, "5");
+   checkPrefix(oSymTable, acPresent, acPrefix);
+   strcpy(acPrefix + LONG_PREFIX_LENGTH, "50");
+   checkPrefix(oSymTable, acPresent, acPrefix);
+   acPrefix[LONG_PREFIX_LENGTH / 2] = '\0';
+   checkPrefix(oSymTable, acPresent, acPrefix);
+   acPrefix[LONG_PREFIX_LENGTH / 2] = 'y';
+   acPrefix[LONG_PREFIX_LENGTH / 2 + 1] = '\0';
+   checkPrefix(oSymTable, acPresent, acPrefix);
+
+   for (i = 0; i < iKeyCount; i++)
+      checkPrefix(oSymTable, acPresent, aacKeys[i]);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_mapPrefix on an empty table, a full table, and a table
+   from which every third key was removed. */
+
+static void testMapPrefix(void)
+{
+   static char acPresent[MAX_SET_KEYS];
+   SymTable_T oSymTable;
+   int iKey;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_mapPrefix.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   makeKeys();
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   memset(acPresent, 0, sizeof(acPresent));
+   checkPrefixes(oSymTable, acPresent);
+
+   /* Put the keys in an order unrelated to their sort order */
+   for (i = 0; i < iKeyCount; i++)
+   {
+      iKey = (int)(((long)i * 7919) % iKeyCount);
+      ASSURE(SymTable_put(oSymTable, aacKeys[iKey], &acValues[iKey]));
+      acPresent[iKey] = 1;
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iKeyCount);
+   checkPrefixes(oSymTable, acPresent);
+
+   for (i = 0; i < iKeyCount; i += 3)
+   {
+      ASSURE(SymTable_remove(oSymTable, aacKeys[i]) == &acValues[i]);
+      acPresent[i] = 0;
+   }
+   checkPrefixes(oSymTable, acPresent);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the function that only the radix tree implementation provides.
+   The command-line arguments are ignored. Return 0. */
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+
+   testMapPrefix();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
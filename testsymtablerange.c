@@ -0,0 +1,173 @@
+/*--------------------------------------------------------------------*/
+/* testsymtablerange.c                                                */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtablerange.c, tests SymTable_mapRange, which     */
+/* only the tree implementation of symtable.h provides, against a     */
+/* brute-force scan of a sorted copy of the keys.                     */
+/*--------------------------------------------------------------------*/
+
+#include "symtable.h"
+#include <stdio.h>
+#include <string.h>
+#include <assert.h>
+#include "testsymtablekeys.h"
+
+/*--------------------------------------------------------------------*/
+
+/* Check that SymTable_mapRange(oSymTable, pcLow, pcHigh, ...) visits
+   exactly the keys of oSymTable in the range, in ascending order.
+   acPresent[i] is 1 if oSymTable holds key number i. */
+
+static void checkRange(SymTable_T oSymTable, const char acPresent[],
+   const char *pcLow, const char *pcHigh)
+{
+   static struct Visits sVisits;
+   int iExpected = 0;
+   int iSorted;
+   int i;
+
+   assert(oSymTable != NULL);
+   assert(acPresent != NULL);
+
+   sVisits.iCount = 0;
+   sVisits.iMismatches = 0;
+   SymTable_mapRange(oSymTable, pcLow, pcHigh, recordVisit, &sVisits);
+   ASSURE(sVisits.iMismatches == 0);
+
+   for (iSorted = 0; iSorted < iKeyCount; iSorted++)
+   {
+      i = aiSorted[iSorted];
+      if (! acPresent[i] ||
+          (pcLow != NULL && strcmp(aacKeys[i], pcLow) < 0) ||
+          (pcHigh != NULL && strcmp(aacKeys[i], pcHigh) >= 0))
+         continue;
+      if (iExpected >= sVisits.iCount ||
+          sVisits.aiKeys[iExpected] != i)
+      {
+         printf("Range [%.20s, %.20s) differs at binding %d.\n",
+            pcLow == NULL ? "(open)" : pcLow,
+            pcHigh == NULL ? "(open)" : pcHigh, iExpected);
+         ASSURE(0);
+         return;
+      }
+      iExpected++;
+   }
+   ASSURE(sVisits.iCount == iExpected);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Check every range whose ends are taken from the keys, from strings
+   that are not keys, and NULL, against oSymTable. */
+
+static void checkRanges(SymTable_T oSymTable, const char acPresent[])
+{
+   enum {MAX_BOUNDS = 80};
+
+   const char *apcBounds[MAX_BOUNDS];
+   char acLongBound[MAX_SET_KEY_LENGTH];
+   int iBoundCount = 0;
+   int iLow;
+   int iHigh;
+   int i;
+
+   assert(oSymTable != NULL);
+   assert(acPresent != NULL);
+
+   apcBounds[iBoundCount++] = NULL;
+   apcBounds[iBoundCount++] = "";
+   apcBounds[iBoundCount++] = "a";
+   apcBounds[iBoundCount++] = "ab";
+   apcBounds[iBoundCount++] = "aba";
+   apcBounds[iBoundCount++] = "abac";
+   apcBounds[iBoundCount++] = "abb";
+   apcBounds[iBoundCount++] = "ac";
+   apcBounds[iBoundCount++] = "b";
+   apcBounds[iBoundCount++] = "bbbbbb";
+   apcBounds[iBoundCount++] = "bbbbbbb";
+   apcBounds[iBoundCount++] = "c";
+   apcBounds[iBoundCount++] = "key";
+   apcBounds[iBoundCount++] = "key1";
+   apcBounds[iBoundCount++] = "key15";
+   apcBounds[iBoundCount++] = "key5";
+   apcBounds[iBoundCount++] = "key999";
+   apcBounds[iBoundCount++] = "kez";
+   apcBounds[iBoundCount++] = "x";
+   apcBounds[iBoundCount++] = "y";
+   apcBounds[iBoundCount++] = "\177";
+
+   /* Bounds inside the run of keys with a long shared prefix */
+   memset(acLongBound, 'x', LONG_PREFIX_LENGTH);
+   strcpy(acLongBound + LONG_PREFIX_LENGTH, "5");
+   apcBounds[iBoundCount++] = acLongBound;
+
+   /* Every fifteenth key */
+   for (i = 0; i < iKeyCount && iBoundCount < MAX_BOUNDS; i += 15)
+      apcBounds[iBoundCount++] = aacKeys[i];
+
+   for (iLow = 0; iLow < iBoundCount; iLow++)
+      for (iHigh = 0; iHigh < iBoundCount; iHigh++)
+         checkRange(oSymTable, acPresent, apcBounds[iLow],
+            apcBounds[iHigh]);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test SymTable_mapRange on an empty table, a full table, and a table
+   from which every third key was removed. */
+
+static void testMapRange(void)
+{
+   static char acPresent[MAX_SET_KEYS];
+   SymTable_T oSymTable;
+   int iKey;
+   int i;
+
+   printf("------------------------------------------------------\n");
+   printf("Testing SymTable_mapRange.\n");
+   printf("No output should appear here:\n");
+   fflush(stdout);
+
+   makeKeys();
+
+   oSymTable = SymTable_new();
+   ASSURE(oSymTable != NULL);
+
+   memset(acPresent, 0, sizeof(acPresent));
+   checkRanges(oSymTable, acPresent);
+
+   /* Put the keys in an order unrelated to their sort order */
+   for (i = 0; i < iKeyCount; i++)
+   {
+      iKey = (int)(((long)i * 7919) % iKeyCount);
+      ASSURE(SymTable_put(oSymTable, aacKeys[iKey], &acValues[iKey]));
+      acPresent[iKey] = 1;
+   }
+   ASSURE(SymTable_getLength(oSymTable) == (size_t)iKeyCount);
+   checkRanges(oSymTable, acPresent);
+
+   for (i = 0; i < iKeyCount; i += 3)
+   {
+      ASSURE(SymTable_remove(oSymTable, aacKeys[i]) == &acValues[i]);
+      acPresent[i] = 0;
+   }
+   checkRanges(oSymTable, acPresent);
+
+   SymTable_free(oSymTable);
+}
+
+/*--------------------------------------------------------------------*/
+
+/* Test the function that only the tree implementation provides. The
+   command-line arguments are ignored. Return 0. */
+
+int main(int argc, char *argv[])
+{
+   (void)argc;
+
+   testMapRange();
+
+   printf("------------------------------------------------------\n");
+   printf("End of %s.\n", argv[0]);
+   return 0;
+}
@@ -0,0 +1,35 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableutil.c                                                 */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtableutil.c, implements the checks, keys and     */
+/* values that the symbol table test clients share.                   */
+/*--------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <assert.h>
+#include "testsymtableutil.h"
+
+/*--------------------------------------------------------------------*/
+
+char acValues[MAX_KEYS];
+
+/*--------------------------------------------------------------------*/
+
+void assure(int iSuccessful, int iLineNum)
+{
+   if (! iSuccessful)
+   {
+      printf("Test at line %d failed.\n", iLineNum);
+      fflush(stdout);
+   }
+}
+
+/*--------------------------------------------------------------------*/
+
+void makeKey(char acKey[], int i)
+{
+   assert(acKey != NULL);
+   assert(i >= 0 && i < MAX_KEYS);
+
+   sprintf(acKey, "key%d", i);
+}
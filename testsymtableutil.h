@@ -0,0 +1,36 @@
+/*--------------------------------------------------------------------*/
+/* testsymtableutil.h                                                 */
+/* Author: Ndongo Njie                                                */
+/* This file, testsymtableutil.h, declares the checks, keys and       */
+/* values that the symbol table test clients share.                   */
+/*--------------------------------------------------------------------*/
+
+#ifndef TestSymTableUtil_INCLUDED
+#define TestSymTableUtil_INCLUDED
+
+#define ASSURE(i) assure(i, __LINE__)
+
+/* The largest number of distinct keys a test uses */
+enum {MAX_KEYS = 200000};
+
+/* The maximum length of a key made by makeKey */
+enum {MAX_KEY_LENGTH = 16};
+
+/* The value bound to key i is &acValues[i], so that a lookup can be
+   checked against its key */
+extern char acValues[MAX_KEYS];
+
+/*--------------------------------------------------------------------*/
+
+/* If !iSuccessful, print a message to stdout indicating that the
+   test at line iLineNum failed. */
+
+void assure(int iSuccessful, int iLineNum);
+
+/*--------------------------------------------------------------------*/
+
+/* Write key number i to acKey. */
+
+void makeKey(char acKey[], int i);
+
+#endif